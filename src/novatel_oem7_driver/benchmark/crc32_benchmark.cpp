@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// Throughput of the Oem7 CRC-32 implementations, for the lengths of typical Oem7 binary messages, and long buffers.
+//
+
+#include <oem7_crc32.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace novatel_oem7_driver;
+
+namespace
+{
+  typedef uint32_t (*CRC32Fn)(const uint8_t*, size_t, uint32_t);
+
+  /**
+   * @return best ns per call, over a buffer of messages of the given length.
+   */
+  double measureNsPerCall(CRC32Fn crc32, const std::vector<uint8_t>& buf, size_t len, uint32_t& checksum)
+  {
+    const size_t num_msgs = buf.size() / len;
+    const int    REPS     = 10;
+
+    double best = 1e30;
+    for(int r = 0; r < REPS; r++)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      for(size_t m = 0; m < num_msgs; m++)
+      {
+        checksum += crc32(&buf[m * len], len, 0);
+      }
+      const auto end = std::chrono::steady_clock::now();
+
+      best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / num_msgs);
+    }
+    return best;
+  }
+}
+
+
+int main()
+{
+  const struct
+  {
+    const char* name;
+    size_t      len;
+  }
+  LENGTHS[] =
+  {
+    {"CORRIMUS",    12 +  60 + 4},
+    {"RAWIMUSX",    12 +  40 + 4},
+    {"BESTPOS",     28 +  72 + 4},
+    {"INSPVAX",     28 + 126 + 4},
+    {"RANGE/20",    28 + 4 + 20 * 44 + 4},
+    {"RANGE/60",    28 + 4 + 60 * 44 + 4},
+    {"64 KiB",      64 * 1024}
+  };
+
+  const struct
+  {
+    const char* name;
+    CRC32Fn     fn;
+  }
+  IMPLS[] =
+  {
+    {"bytewise",   Oem7CRC32Bytewise},
+    {"slice-by-8", Oem7CRC32Slice8},
+    {"PCLMUL",     Oem7CRC32PCLMUL}
+  };
+
+  std::vector<uint8_t> buf(4 * 1024 * 1024);
+  std::mt19937 rng(42);
+  for(auto& b: buf)
+  {
+    b = rng();
+  }
+
+  printf("Oem7CRC32: %s; PCLMUL supported: %s\n", getOem7CRC32Name(), isOem7CRC32PCLMULSupported() ? "yes" : "no");
+  printf("%-10s %6s", "message", "bytes");
+  for(const auto& impl: IMPLS)
+  {
+    printf("  %22s", impl.name);
+  }
+  printf("\n");
+
+  uint32_t checksum = 0;
+  for(const auto& l: LENGTHS)
+  {
+    printf("%-10s %6zu", l.name, l.len);
+    for(const auto& impl: IMPLS)
+    {
+      const double ns = measureNsPerCall(impl.fn, buf, l.len, checksum);
+      printf("  %8.1f ns %6.2f GB/s", ns, l.len / ns);
+    }
+    printf("\n");
+  }
+  printf("(checksum %08x)\n", checksum);
+
+  return 0;
+}
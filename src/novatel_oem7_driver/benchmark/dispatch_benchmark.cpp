@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Compares message dispatch latency of Oem7DispatchTable against the std::map based dispatch
+// it replaced in MessageHandler, for a message mix produced by the standard logging configuration.
+//
+
+#include <oem7_dispatch_table.hpp>
+#include <novatel_oem7_driver/oem7_message_ids.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace novatel_oem7_driver;
+
+namespace
+{
+  /**
+   * Stand-in for a message handler plugin.
+   */
+  class Handler
+  {
+    std::vector<int> ids_;
+
+  public:
+    uint64_t count;
+
+    explicit Handler(const std::vector<int>& ids): ids_(ids), count(0) {}
+    virtual ~Handler() {}
+
+    const std::vector<int>& getMessageIds() { return ids_; }
+
+    virtual void handleMsg(int msg_id)
+    {
+      count += msg_id;
+    }
+  };
+
+  typedef boost::shared_ptr<Handler> HandlerShPtr;
+
+  /**
+   * Dispatch structure used by MessageHandler previously.
+   */
+  class MapDispatcher
+  {
+    typedef std::list<HandlerShPtr> HandlerList;
+    std::map<int, boost::scoped_ptr<HandlerList> > map_;
+
+  public:
+    explicit MapDispatcher(const std::vector<HandlerShPtr>& handlers)
+    {
+      for(const auto& h: handlers)
+      {
+        for(int id: h->getMessageIds())
+        {
+          if(map_.find(id) == map_.end())
+          {
+            map_[id].reset(new HandlerList);
+          }
+          map_[id]->push_back(h);
+        }
+      }
+    }
+
+    void dispatch(int msg_id)
+    {
+      auto itr = map_.find(msg_id);
+      if(itr == map_.end())
+        return;
+
+      for(auto& h: *itr->second)
+      {
+        h->handleMsg(msg_id);
+      }
+    }
+  };
+
+  class TableDispatcher
+  {
+    Oem7DispatchTable<Handler*> table_;
+
+  public:
+    explicit TableDispatcher(const std::vector<HandlerShPtr>& handlers)
+    {
+      for(const auto& h: handlers)
+      {
+        for(int id: h->getMessageIds())
+        {
+          table_.add(id, h.get());
+        }
+      }
+      table_.build();
+    }
+
+    void dispatch(int msg_id)
+    {
+      for(Handler* h: table_.lookup(msg_id))
+      {
+        h->handleMsg(msg_id);
+      }
+    }
+  };
+
+  /**
+   * Message IDs in the proportions of std_init_commands.yaml, per second of output.
+   */
+  std::vector<int> makeMessageMix(size_t num_msgs)
+  {
+    const std::vector<std::pair<int, int> > rates = // {ID, Hz}
+    {
+      {CORRIMUS_OEM7_MSGID,        100},
+      {RAWIMUSX_OEM7_MSGID,        100},
+      {INSPVAS_OEM7_MSGID,          50},
+      {BESTPOS_OEM7_MSGID,          10},
+      {BESTVEL_OEM7_MSGID,          10},
+      {HEADING2_OEM7_MSGID,          5},
+      {BESTUTM_OEM7_MSGID,           1},
+      {INSPVAX_OEM7_MSGID,           1},
+      {INSSTDEV_OEM7_MSGID,          1},
+      {TIME_OEM7_MSGID,              1},
+      {PSRDOP2_OEM7_MSGID,           1},
+      {RANGE_OEM7_MSGID,             1},
+      {INSUPDATESTATUS_OEM7_MSGID,   1},
+      {GPGGA_OEM7_MSGID,             1},
+      {RXSTATUS_OEM7_MSGID,          1}
+    };
+
+    std::vector<int> weights;
+    for(const auto& r: rates)
+    {
+      weights.push_back(r.second);
+    }
+
+    std::mt19937 rng(42);
+    std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
+
+    std::vector<int> mix(num_msgs);
+    for(auto& id: mix)
+    {
+      id = rates[dist(rng)].first;
+    }
+    return mix;
+  }
+
+  template <typename D>
+  double measureNsPerMsg(D& dispatcher, const std::vector<int>& mix, int reps)
+  {
+    double best = 1e30;
+    for(int r = 0; r < reps; r++)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      for(int id: mix)
+      {
+        dispatcher.dispatch(id);
+      }
+      const auto end = std::chrono::steady_clock::now();
+
+      const double ns = std::chrono::duration<double, std::nano>(end - start).count() / mix.size();
+      best = std::min(best, ns);
+    }
+    return best;
+  }
+}
+
+
+int main()
+{
+  // Handlers registered by std_msg_handlers.yaml, with the same message IDs.
+  std::vector<HandlerShPtr> handlers =
+  {
+    HandlerShPtr(new Handler({HEADING2_OEM7_MSGID})),
+    HandlerShPtr(new Handler({BESTPOS_OEM7_MSGID, BESTVEL_OEM7_MSGID, BESTUTM_OEM7_MSGID,
+                              INSPVAS_OEM7_MSGID, INSPVAX_OEM7_MSGID, PSRDOP2_OEM7_MSGID})),
+    HandlerShPtr(new Handler({CORRIMUS_OEM7_MSGID, IMURATECORRIMUS_OEM7_MSGID, INSPVAS_OEM7_MSGID,
+                              INSPVAX_OEM7_MSGID, INSSTDEV_OEM7_MSGID, INSCONFIG_OEM7_MSGID,
+                              INSUPDATESTATUS_OEM7_MSGID})),
+    HandlerShPtr(new Handler({RXSTATUS_OEM7_MSGID})),
+    HandlerShPtr(new Handler({TIME_OEM7_MSGID})),
+    HandlerShPtr(new Handler({RANGE_OEM7_MSGID})),
+    HandlerShPtr(new Handler({RAWIMUSX_OEM7_MSGID})),
+    HandlerShPtr(new Handler({GLMLA_OEM7_MSGID, GPALM_OEM7_MSGID, GPGGA_OEM7_MSGID, GPGGALONG_OEM7_MSGID,
+                              GPGLL_OEM7_MSGID, GPGRS_OEM7_MSGID, GPGSA_OEM7_MSGID, GPGST_OEM7_MSGID,
+                              GPGSV_OEM7_MSGID, GPHDT_OEM7_MSGID, GPRMB_OEM7_MSGID, GPRMC_OEM7_MSGID,
+                              GPVTG_OEM7_MSGID, GPZDA_OEM7_MSGID}))
+  };
+
+  const size_t NUM_MSGS = 1 << 20;
+  const int    REPS     = 10;
+
+  const std::vector<int> mix = makeMessageMix(NUM_MSGS);
+
+  MapDispatcher   map_dispatcher(handlers);
+  TableDispatcher table_dispatcher(handlers);
+
+  const double map_ns   = measureNsPerMsg(map_dispatcher,   mix, REPS);
+  const double table_ns = measureNsPerMsg(table_dispatcher, mix, REPS);
+
+  uint64_t checksum = 0;
+  for(const auto& h: handlers)
+  {
+    checksum += h->count;
+  }
+
+  printf("Dispatch of %zu messages, best of %d:\n", NUM_MSGS, REPS);
+  printf("  std::map:           %6.2f ns/msg\n", map_ns);
+  printf("  Oem7DispatchTable:  %6.2f ns/msg  (%.2fx)\n", table_ns, map_ns / table_ns);
+  printf("  (checksum %llu)\n", static_cast<unsigned long long>(checksum));
+
+  return 0;
+}
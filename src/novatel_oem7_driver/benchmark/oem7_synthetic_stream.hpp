@@ -0,0 +1,296 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_SYNTHETIC_STREAM_HPP__
+#define __OEM7_SYNTHETIC_STREAM_HPP__
+
+#include <novatel_oem7_driver/oem7_message_ids.h>
+#include <novatel_oem7_driver/oem7_messages.h>
+
+#include <oem7_crc32.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Generates a stream of binary Oem7 logs, as output by a receiver logging at the configured rates;
+   * for benchmarks. Logs carry plausible, slowly varying content, GPS time and a valid CRC.
+   */
+  class Oem7SyntheticStream
+  {
+  public:
+    /**
+     * A log and its output rate.
+     */
+    struct Log
+    {
+      std::string name;
+      int         id;
+      double      rate; ///< Hz; 0: not output
+    };
+
+    static const uint16_t GPS_WEEK          = 2200;
+    static const uint32_t GPS_WEEK_START_MS = 345600000;
+
+  private:
+    std::vector<Log> logs_;
+    size_t range_obs_; ///< Observations per RANGE log
+
+    uint16_t sequence_;
+
+
+    static void append(std::vector<uint8_t>& out, const void* data, size_t len)
+    {
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      out.insert(out.end(), bytes, bytes + len);
+    }
+
+    static void appendCRC(std::vector<uint8_t>& out, size_t frame_start)
+    {
+      const uint32_t crc = Oem7CRC32(&out[frame_start], out.size() - frame_start);
+      append(out, &crc, sizeof(crc));
+    }
+
+    void appendLog(std::vector<uint8_t>& out, int id, uint32_t gps_ms, const std::vector<uint8_t>& body)
+    {
+      Oem7MessageHeaderMem hdr;
+      memset(&hdr, 0, sizeof(hdr));
+      hdr.sync1            = static_cast<char>(0xAA);
+      hdr.sync2            = static_cast<char>(0x44);
+      hdr.sync3            = static_cast<char>(0x12);
+      hdr.header_length    = sizeof(hdr);
+      hdr.message_id       = id;
+      hdr.port_address     = 0x20; // COM1
+      hdr.message_length   = body.size();
+      hdr.sequence         = sequence_++;
+      hdr.time_status      = 180;  // FINESTEERING
+      hdr.gps_week         = GPS_WEEK;
+      hdr.gps_milliseconds = gps_ms;
+      hdr.recevier_version = 0x3FA2;
+
+      const size_t start = out.size();
+      append(out, &hdr, sizeof(hdr));
+      append(out, body.data(), body.size());
+      appendCRC(out, start);
+    }
+
+    void appendShortLog(std::vector<uint8_t>& out, int id, uint32_t gps_ms, const std::vector<uint8_t>& body)
+    {
+      Oem7MessgeShortHeaderMem hdr;
+      hdr.sync1            = static_cast<char>(0xAA);
+      hdr.sync2            = static_cast<char>(0x44);
+      hdr.sync3            = static_cast<char>(0x13);
+      hdr.message_length   = body.size();
+      hdr.message_id       = id;
+      hdr.gps_week         = GPS_WEEK;
+      hdr.gps_milliseconds = gps_ms;
+
+      const size_t start = out.size();
+      append(out, &hdr, sizeof(hdr));
+      append(out, body.data(), body.size());
+      appendCRC(out, start);
+    }
+
+    template <typename T>
+    static std::vector<uint8_t> bytes(const T& mem)
+    {
+      const uint8_t* p = reinterpret_cast<const uint8_t*>(&mem);
+      return std::vector<uint8_t>(p, p + sizeof(mem));
+    }
+
+    /**
+     * Vehicle circling at 10 m/s; t: seconds since start.
+     */
+    static void trajectory(double t, double& lat, double& lon, double& azimuth)
+    {
+      const double RADIUS = 100.0; // m
+      const double a = t * 10.0 / RADIUS;
+      lat     = 51.0   + RADIUS * std::sin(a) / 111320.0;
+      lon     = -114.0 + RADIUS * std::cos(a) / (111320.0 * std::cos(51.0 * M_PI / 180.0));
+      azimuth = std::fmod(360.0 - a * 180.0 / M_PI, 360.0);
+    }
+
+    void appendBody(std::vector<uint8_t>& out, int id, uint32_t gps_ms, double t)
+    {
+      double lat, lon, azimuth;
+      trajectory(t, lat, lon, azimuth);
+
+      if(id == BESTPOS_OEM7_MSGID)
+      {
+        BESTPOSMem bestpos;
+        memset(&bestpos, 0, sizeof(bestpos));
+        bestpos.pos_type    = 56; // INS_RTKFIXED
+        bestpos.lat         = lat;
+        bestpos.lon         = lon;
+        bestpos.hgt         = 1100.0;
+        bestpos.undulation  = -17.0f;
+        bestpos.datum_id    = 61; // WGS84
+        bestpos.lat_stdev   = 0.02f;
+        bestpos.lon_stdev   = 0.02f;
+        bestpos.hgt_stdev   = 0.04f;
+        bestpos.num_svs     = 24;
+        bestpos.num_sol_svs = 20;
+        appendLog(out, id, gps_ms, bytes(bestpos));
+      }
+      else if(id == INSPVAS_OEM7_MSGID)
+      {
+        INSPVASmem inspvas;
+        inspvas.gnss_week      = GPS_WEEK;
+        inspvas.seconds        = gps_ms / 1000.0;
+        inspvas.latitude       = lat;
+        inspvas.longitude      = lon;
+        inspvas.height         = 1100.0;
+        inspvas.north_velocity = 10.0 * std::cos(azimuth * M_PI / 180.0);
+        inspvas.east_velocity  = 10.0 * std::sin(azimuth * M_PI / 180.0);
+        inspvas.up_velocity    = 0.0;
+        inspvas.roll           = 1.5;
+        inspvas.pitch          = -0.5;
+        inspvas.azimuth        = azimuth;
+        inspvas.status         = 3; // INS_SOLUTION_GOOD
+        appendShortLog(out, id, gps_ms, bytes(inspvas));
+      }
+      else if(id == CORRIMUS_OEM7_MSGID)
+      {
+        CORRIMUSMem corrimus;
+        memset(&corrimus, 0, sizeof(corrimus));
+        corrimus.imu_data_count   = 1;
+        corrimus.yaw_rate         = -0.1 / 100.0; // Per IMU sample, at 100 Hz
+        corrimus.lateral_acc      = 1.0  / 100.0;
+        corrimus.vertical_acc     = 9.81 / 100.0;
+        appendShortLog(out, id, gps_ms, bytes(corrimus));
+      }
+      else if(id == RANGE_OEM7_MSGID)
+      {
+        std::vector<uint8_t> body;
+        RANGE_FixedMem range;
+        range.num_obs = range_obs_;
+        append(body, &range, sizeof(range));
+
+        for(size_t o = 0; o < range_obs_; o++)
+        {
+          RANGE_ObservationMem obs;
+          memset(&obs, 0, sizeof(obs));
+          obs.prn          = 1 + o;
+          obs.psr          = 2.0e7 + 1000.0 * o + t;
+          obs.psr_std      = 0.05f;
+          obs.adr          = -1.0e8 - 5000.0 * o - 5.0 * t;
+          obs.adr_std      = 0.005f;
+          obs.dopp         = 1000.0f - o;
+          obs.cno          = 45.0f;
+          obs.locktime     = t;
+          obs.ch_tr_status = 0x08109C04;
+          append(body, &obs, sizeof(obs));
+        }
+        appendLog(out, id, gps_ms, body);
+      }
+      else if(id == RXSTATUS_OEM7_MSGID)
+      {
+        RXSTATUSMem rxstatus;
+        memset(&rxstatus, 0, sizeof(rxstatus));
+        rxstatus.num_status_codes = 4;
+        appendLog(out, id, gps_ms, bytes(rxstatus));
+      }
+    }
+
+  public:
+    Oem7SyntheticStream():
+      range_obs_(20),
+      sequence_(0)
+    {
+      logs_.push_back({"BESTPOS",  BESTPOS_OEM7_MSGID,   10.0});
+      logs_.push_back({"INSPVAS",  INSPVAS_OEM7_MSGID,  100.0});
+      logs_.push_back({"CORRIMUS", CORRIMUS_OEM7_MSGID, 100.0});
+      logs_.push_back({"RANGE",    RANGE_OEM7_MSGID,      1.0});
+      logs_.push_back({"RXSTATUS", RXSTATUS_OEM7_MSGID,   1.0});
+    }
+
+    const std::vector<Log>& getLogs() const
+    {
+      return logs_;
+    }
+
+    /**
+     * @return false if the log is not supported.
+     */
+    bool setRate(const std::string& name, double rate)
+    {
+      for(auto& log: logs_)
+      {
+        if(log.name == name)
+        {
+          log.rate = std::max(rate, 0.0);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void setRangeObservations(size_t num_obs)
+    {
+      range_obs_ = num_obs;
+    }
+
+    /**
+     * Generates the output of the given number of seconds.
+     *
+     * @return the number of logs generated.
+     */
+    size_t generate(double seconds, std::vector<uint8_t>& out)
+    {
+      std::vector<std::pair<uint32_t, int> > schedule; // {GPS ms, ID}; logs are output in time order.
+      for(const auto& log: logs_)
+      {
+        if(log.rate <= 0.0)
+          continue;
+
+        const size_t num = static_cast<size_t>(seconds * log.rate);
+        for(size_t n = 0; n < num; n++)
+        {
+          schedule.push_back(std::make_pair(static_cast<uint32_t>(std::llround(n * 1000.0 / log.rate)), log.id));
+        }
+      }
+      std::stable_sort(schedule.begin(), schedule.end(),
+                       [](const std::pair<uint32_t, int>& a, const std::pair<uint32_t, int>& b)
+                       {
+                         return a.first < b.first;
+                       });
+
+      for(const auto& entry: schedule)
+      {
+        appendBody(out, entry.second, GPS_WEEK_START_MS + entry.first, entry.first / 1000.0);
+      }
+
+      return schedule.size();
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,330 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// Measures throughput, latency and heap allocations of the message pipeline: a synthetic receiver streams binary
+// Oem7 logs into the Oem7MessageDecoder plugin; decoded messages are dispatched by MessageHandler to the handler
+// plugins configured in 'oem7_msg_handlers', which publish to null publishers: ROS messages are built and stamped,
+// but not sent.
+//
+// Requires a ROS master for parameters and plugin loading; run with:
+//   roslaunch novatel_oem7_driver oem7_pipeline_benchmark.launch [args:="..."]
+//
+// Options:
+//   --seconds S     Seconds of receiver output to generate; default 600
+//   --reps N        Repetitions, best reported; default 5
+//   --chunk B       Bytes per receiver read; default 4096
+//   --range-obs N   Observations per RANGE log; default 20
+//   --rate LOG=HZ   Output rate of LOG: BESTPOS, INSPVAS, CORRIMUS, RANGE, RXSTATUS; 0 disables. Repeatable.
+//   --decoder NAME  Decoder plugin; default Oem7MessageDecoder
+//
+
+#include <ros/ros.h>
+#include <pluginlib/class_loader.h>
+
+#include <novatel_oem7_driver/oem7_message_decoder_if.hpp>
+#include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <novatel_oem7_driver/oem7_message_util.hpp>
+
+#include <message_handler.hpp>
+#include <oem7_ros_publisher.hpp>
+#include <oem7_message_context.hpp>
+
+#include "oem7_synthetic_stream.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace novatel_oem7_driver;
+
+
+namespace
+{
+  std::atomic<uint64_t> g_num_allocs(0); ///< Heap allocations, by any thread.
+}
+
+void* operator new(std::size_t size)
+{
+  g_num_allocs.fetch_add(1, std::memory_order_relaxed);
+
+  void* p = malloc(size ? size : 1);
+  if(!p)
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+
+namespace
+{
+  /**
+   * Receiver streaming a memory buffer, in chunks of fixed size.
+   */
+  class SyntheticReceiver: public Oem7ReceiverIf
+  {
+    const std::vector<uint8_t>& stream_;
+    const size_t chunk_size_;
+    size_t pos_;
+
+  public:
+    SyntheticReceiver(const std::vector<uint8_t>& stream, size_t chunk_size):
+      stream_(stream),
+      chunk_size_(chunk_size),
+      pos_(0)
+    {
+    }
+
+    bool initialize(ros::NodeHandle&)
+    {
+      return true;
+    }
+
+    bool read(boost::asio::mutable_buffer buf, size_t& s)
+    {
+      if(pos_ >= stream_.size())
+      {
+        s = 0;
+        return false;
+      }
+
+      s = std::min(std::min(boost::asio::buffer_size(buf), chunk_size_), stream_.size() - pos_);
+      memcpy(boost::asio::buffer_cast<uint8_t*>(buf), &stream_[pos_], s);
+      pos_ += s;
+      return true;
+    }
+
+    bool write(boost::asio::const_buffer)
+    {
+      return true;
+    }
+  };
+
+  /**
+   * Decoder user: collects decoded messages, or hands them to MessageHandler, as Oem7ReceiverSession does.
+   */
+  class PipelineUser: public Oem7MessageDecoderUserIf
+  {
+    MessageHandler* handler_; ///< NULL: collect only
+    std::vector<Oem7RawMessageIf::ConstPtr>* collected_;
+
+  public:
+    size_t num_msgs;
+
+    PipelineUser(MessageHandler* handler, std::vector<Oem7RawMessageIf::ConstPtr>* collected):
+      handler_(handler),
+      collected_(collected),
+      num_msgs(0)
+    {
+    }
+
+    void onNewMessage(Oem7RawMessageIf::ConstPtr msg)
+    {
+      onNewStampedMessage(msg, Oem7InputArrival());
+    }
+
+    void onNewStampedMessage(Oem7RawMessageIf::ConstPtr msg, const Oem7InputArrival& arrival)
+    {
+      num_msgs++;
+
+      if(handler_)
+      {
+        Oem7MessageScope scope(arrival.stamp);
+        handler_->handleMessage(msg);
+      }
+      else if(collected_)
+      {
+        collected_->push_back(msg);
+      }
+    }
+  };
+
+  struct StageResult
+  {
+    const char* name;
+    size_t      num_msgs;
+    double      seconds;    ///< Best of repetitions
+    uint64_t    num_allocs; ///< Of the last repetition; pools are warm by then.
+
+    StageResult(const char* n):
+      name(n), num_msgs(0), seconds(1e30), num_allocs(0)
+    {
+    }
+
+    void add(size_t msgs, double s, uint64_t allocs)
+    {
+      num_msgs   = msgs;
+      seconds    = std::min(seconds, s);
+      num_allocs = allocs;
+    }
+
+    void print() const
+    {
+      printf("  %-18s %10.0f msg/s  %8.1f ns/msg  %6.2f allocs/msg\n",
+             name,
+             num_msgs / seconds,
+             seconds * 1e9 / num_msgs,
+             static_cast<double>(num_allocs) / num_msgs);
+    }
+  };
+
+  typedef pluginlib::ClassLoader<Oem7MessageDecoderIf> DecoderLoader;
+
+  /**
+   * Decodes the stream with a new decoder; messages are handled by the user.
+   */
+  void runDecoder(DecoderLoader& loader, const std::string& decoder_name, ros::NodeHandle& nh,
+                  const std::vector<uint8_t>& stream, size_t chunk, PipelineUser& user, StageResult& result)
+  {
+    SyntheticReceiver recvr(stream, chunk);
+
+    boost::shared_ptr<Oem7MessageDecoderIf> decoder = loader.createInstance(decoder_name);
+    decoder->initialize(nh, &recvr, &user);
+
+    const uint64_t allocs = g_num_allocs;
+    const auto start = std::chrono::steady_clock::now();
+    decoder->service();
+    const auto end   = std::chrono::steady_clock::now();
+
+    result.add(user.num_msgs, std::chrono::duration<double>(end - start).count(), g_num_allocs - allocs);
+  }
+
+  /**
+   * Parses 'LOG=HZ'.
+   */
+  bool setRate(Oem7SyntheticStream& generator, const std::string& log_rate)
+  {
+    const size_t eq = log_rate.find('=');
+    return eq != std::string::npos &&
+           generator.setRate(log_rate.substr(0, eq), std::atof(log_rate.c_str() + eq + 1));
+  }
+
+  void usage()
+  {
+    fprintf(stderr, "Options: --seconds S --reps N --chunk B --range-obs N --rate LOG=HZ --decoder NAME\n");
+  }
+}
+
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "oem7_pipeline_benchmark"); // Removes ROS arguments.
+
+  Oem7SyntheticStream generator;
+  double seconds = 600.0;
+  int    reps    = 5;
+  size_t chunk   = 4096;
+  std::string decoder_name = "Oem7MessageDecoder";
+
+  for(int a = 1; a < argc; a++)
+  {
+    const std::string arg = argv[a];
+    if(a + 1 >= argc)
+    {
+      usage();
+      return 1;
+    }
+    const std::string val = argv[++a];
+
+    if(     arg == "--seconds")   seconds = std::atof(val.c_str());
+    else if(arg == "--reps")      reps    = std::max(std::atoi(val.c_str()), 1);
+    else if(arg == "--chunk")     chunk   = std::max(std::atoi(val.c_str()), 1);
+    else if(arg == "--range-obs") generator.setRangeObservations(std::max(std::atoi(val.c_str()), 0));
+    else if(arg == "--rate" && setRate(generator, val)) {}
+    else if(arg == "--decoder")   decoder_name = val;
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  ros::NodeHandle nh("~");
+  initializeOem7MessageUtil(nh);
+
+  nh.setParam("oem7_null_publishing", true); // Handlers' publishers drop messages instead of sending them.
+  MessageHandler handler(nh);
+
+  DecoderLoader decoder_loader("novatel_oem7_driver", "novatel_oem7_driver::Oem7MessageDecoderIf");
+
+  std::vector<uint8_t> stream;
+  const size_t num_logs = generator.generate(seconds, stream);
+
+  std::vector<Oem7RawMessageIf::ConstPtr> decoded;
+  decoded.reserve(num_logs);
+
+  StageResult decode_result(  "decode");
+  StageResult handle_result(  "dispatch+handle");
+  StageResult pipeline_result("pipeline");
+
+  for(int r = 0; r < reps; r++)
+  {
+    // Decoding alone; the messages are kept for the next stage.
+    decoded.clear();
+    {
+      PipelineUser user(NULL, &decoded);
+      runDecoder(decoder_loader, decoder_name, nh, stream, chunk, user, decode_result);
+    }
+
+    // Dispatch and handling alone, of decoded messages.
+    {
+      const uint64_t allocs = g_num_allocs;
+      const auto start = std::chrono::steady_clock::now();
+      for(const auto& msg: decoded)
+      {
+        handler.handleMessage(msg);
+      }
+      const auto end   = std::chrono::steady_clock::now();
+      handle_result.add(decoded.size(), std::chrono::duration<double>(end - start).count(), g_num_allocs - allocs);
+    }
+
+    // End to end.
+    {
+      PipelineUser user(&handler, NULL);
+      runDecoder(decoder_loader, decoder_name, nh, stream, chunk, user, pipeline_result);
+    }
+  }
+
+  printf("Pipeline: %s; %zu logs, %.1f MB; %.0f s of receiver output, best of %d:\n",
+         decoder_name.c_str(), num_logs, stream.size() / 1e6, seconds, reps);
+  for(const auto& log: generator.getLogs())
+  {
+    printf("  %-9s %6.1f Hz\n", log.name.c_str(), log.rate);
+  }
+  decode_result.print();
+  handle_result.print();
+  pipeline_result.print();
+
+  return 0;
+}
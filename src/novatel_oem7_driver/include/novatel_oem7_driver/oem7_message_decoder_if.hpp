@@ -50,6 +50,17 @@ namespace novatel_oem7_driver
      * Called when new message is available.
      */
     virtual void onNewMessage(boost::shared_ptr<const novatel_oem7::Oem7RawMessageIf>) = 0;
+
+    /**
+     * Called when new message is available, with the arrival of the input which completed it.
+     * By default, the arrival is discarded.
+     */
+    virtual void onNewStampedMessage(
+        boost::shared_ptr<const novatel_oem7::Oem7RawMessageIf> msg,
+        const Oem7InputArrival&                                  /* arrival */)
+    {
+      onNewMessage(msg);
+    }
   };
 
 
@@ -78,6 +89,27 @@ namespace novatel_oem7_driver
      * Returns when no more input is available; or when ros::ok() returns false.
      */
     virtual void service() = 0;
+
+    /**
+     * @return true if the decoder implements serviceAvailable(); required for pooled decoding.
+     */
+    virtual bool supportsServiceAvailable() const
+    {
+      return false;
+    }
+
+    /**
+     * Decodes the input available now, making at most max_msgs callbacks; for decoding driven by the user,
+     * e.g. from a worker pool. The receiver must not block in read(), and return no data when none is available.
+     * Optional, see supportsServiceAvailable(); by default, nothing is decoded.
+     *
+     * @return false when no more input is available, as a permanent condition; or when ros::ok() returns false.
+     */
+    virtual bool serviceAvailable(size_t /* max_msgs */)
+    {
+      ROS_ERROR("Decoder: pooled decoding is not supported.");
+      return false;
+    }
   };
 }
 
@@ -85,6 +85,17 @@ namespace novatel_oem7_driver
 
   bool isNMEAMessage(const Oem7RawMessageIf::ConstPtr& raw_msg);
 
+  /**
+   * Obtains GPS time from the header of a binary or 'short' binary message.
+   *
+   * @return false if the message is not binary, and the time is not available.
+   */
+  bool getOem7MessageGPSTime(
+      const Oem7RawMessageIf::ConstPtr& raw_msg, ///< [in] Raw message
+      uint16_t& gps_week,                        ///< [out] GPS week number
+      uint32_t& gps_milliseconds                 ///< [out] Milliseconds into GPS week
+      );
+
   size_t Get_INSCONFIG_NumTranslations(const INSCONFIG_FixedMem* insconfig);
 
   const INSCONFIG_TranslationMem* Get_INSCONFIG_Translation(const INSCONFIG_FixedMem* insconfig, size_t idx);
@@ -96,6 +107,9 @@ namespace novatel_oem7_driver
 
   size_t Get_PSRDOP2_NumSystems(const PSRDOP2_FixedMem* psrdop2);
   const PSRDOP2_SystemMem* Get_PSRDOP2_System(const PSRDOP2_FixedMem* psrdop2, size_t idx);
+
+  size_t Get_RANGE_NumObservations(const RANGE_FixedMem* range);
+  const RANGE_ObservationMem* Get_RANGE_Observation(const RANGE_FixedMem* range, size_t idx);
 }
 
 
@@ -205,6 +205,22 @@ namespace novatel_oem7_driver
   };
   static_assert(sizeof(INSSTDEVMem) == 52, ASSERT_MSG);
 
+  struct __attribute__((packed))
+  INSUPDATESTATUSMem
+  {
+    oem7_enum_t    pos_type;
+    int32_t        num_psr;
+    int32_t        num_adr;
+    int32_t        num_dop;
+    oem7_enum_t    dmi_update_status;
+    oem7_enum_t    heading_update_status;
+    uint32_t       ext_sol_status;
+    uint32_t       update_option_indicators;
+    uint32_t       reserved1;
+    uint32_t       reserved2;
+  };
+  static_assert(sizeof(INSUPDATESTATUSMem) == 40, ASSERT_MSG);
+
 
   struct __attribute__((packed))
   INSCONFIG_FixedMem
@@ -407,6 +423,46 @@ namespace novatel_oem7_driver
     float    tdop;
   };
 
+  struct __attribute__((packed))
+  RANGE_FixedMem
+  {
+    uint32_t   num_obs;
+  };
+  static_assert(sizeof(RANGE_FixedMem) == 4, ASSERT_MSG);
+
+  struct __attribute__((packed))
+  RANGE_ObservationMem
+  {
+    uint16_t   prn;
+    uint16_t   glofreq;
+    double     psr;
+    float      psr_std;
+    double     adr;
+    float      adr_std;
+    float      dopp;
+    float      cno;
+    float      locktime;
+    uint32_t   ch_tr_status;
+  };
+  static_assert(sizeof(RANGE_ObservationMem) == 44, ASSERT_MSG);
+
+  struct __attribute__((packed))
+  RAWIMUSXMem
+  {
+    uint8_t    imu_info;
+    uint8_t    imu_type;
+    uint16_t   gnss_week;
+    double     gnss_week_seconds;
+    uint32_t   imu_status;
+    int32_t    z_accel;
+    int32_t    neg_y_accel; ///< -(Y accel)
+    int32_t    x_accel;
+    int32_t    z_gyro;
+    int32_t    neg_y_gyro;  ///< -(Y gyro)
+    int32_t    x_gyro;
+  };
+  static_assert(sizeof(RAWIMUSXMem) == 40, ASSERT_MSG);
+
 
   const std::size_t OEM7_BINARY_MSG_HDR_LEN       = sizeof(Oem7MessageHeaderMem);
   const std::size_t OEM7_BINARY_MSG_SHORT_HDR_LEN = sizeof(Oem7MessgeShortHeaderMem);
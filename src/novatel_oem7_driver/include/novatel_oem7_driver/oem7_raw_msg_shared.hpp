@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_RAW_MSG_SHARED_HPP__
+#define __OEM7_RAW_MSG_SHARED_HPP__
+
+#include <ros/ros.h>
+#include <ros/message_traits.h>
+#include <ros/serialization.h>
+
+#include <std_msgs/Header.h>
+#include "novatel_oem7_msgs/Oem7RawMsg.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <cstring>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * In-memory variant of novatel_oem7_msgs::Oem7RawMsg, which shares the message data instead of owning a copy.
+   *
+   * It is wire-compatible with Oem7RawMsg (same type, MD5 and definition): remote subscribers and bags see
+   * Oem7RawMsg. Intra-process subscribers to Oem7RawMsgShared receive the published instance, and the frame bytes
+   * are never copied; subscribers to Oem7RawMsg are served by serialization, as with any other message.
+   */
+  struct Oem7RawMsgShared
+  {
+    typedef boost::shared_ptr<Oem7RawMsgShared>       Ptr;
+    typedef boost::shared_ptr<const Oem7RawMsgShared> ConstPtr;
+
+    std_msgs::Header header;
+
+    boost::shared_ptr<const uint8_t> message_data;     ///< Frame bytes; may alias the owner of a larger buffer.
+    uint32_t                         message_data_len; ///< Frame length, bytes.
+
+    Oem7RawMsgShared():
+      message_data_len(0)
+    {
+    }
+
+    const uint8_t* data() const
+    {
+      return message_data.get();
+    }
+
+    size_t size() const
+    {
+      return message_data_len;
+    }
+  };
+}
+
+
+namespace ros
+{
+namespace message_traits
+{
+  template<> struct IsMessage<novatel_oem7_driver::Oem7RawMsgShared>       : TrueType  {};
+  template<> struct IsMessage<const novatel_oem7_driver::Oem7RawMsgShared> : TrueType  {};
+  template<> struct HasHeader<novatel_oem7_driver::Oem7RawMsgShared>       : TrueType  {};
+  template<> struct HasHeader<const novatel_oem7_driver::Oem7RawMsgShared> : TrueType  {};
+  template<> struct IsFixedSize<novatel_oem7_driver::Oem7RawMsgShared>     : FalseType {};
+
+  template<>
+  struct MD5Sum<novatel_oem7_driver::Oem7RawMsgShared>
+  {
+    static const char* value()
+    {
+      return MD5Sum<novatel_oem7_msgs::Oem7RawMsg>::value();
+    }
+
+    static const char* value(const novatel_oem7_driver::Oem7RawMsgShared&)
+    {
+      return value();
+    }
+  };
+
+  template<>
+  struct DataType<novatel_oem7_driver::Oem7RawMsgShared>
+  {
+    static const char* value()
+    {
+      return DataType<novatel_oem7_msgs::Oem7RawMsg>::value();
+    }
+
+    static const char* value(const novatel_oem7_driver::Oem7RawMsgShared&)
+    {
+      return value();
+    }
+  };
+
+  template<>
+  struct Definition<novatel_oem7_driver::Oem7RawMsgShared>
+  {
+    static const char* value()
+    {
+      return Definition<novatel_oem7_msgs::Oem7RawMsg>::value();
+    }
+
+    static const char* value(const novatel_oem7_driver::Oem7RawMsgShared&)
+    {
+      return value();
+    }
+  };
+}
+
+namespace serialization
+{
+  /**
+   * Serializes as Oem7RawMsg: header, then uint8[] message_data.
+   */
+  template<>
+  struct Serializer<novatel_oem7_driver::Oem7RawMsgShared>
+  {
+    template<typename Stream>
+    inline static void write(Stream& stream, const novatel_oem7_driver::Oem7RawMsgShared& m)
+    {
+      stream.next(m.header);
+      stream.next(m.message_data_len);
+      if(m.message_data_len > 0)
+      {
+        memcpy(stream.advance(m.message_data_len), m.message_data.get(), m.message_data_len);
+      }
+    }
+
+    template<typename Stream>
+    inline static void read(Stream& stream, novatel_oem7_driver::Oem7RawMsgShared& m)
+    {
+      stream.next(m.header);
+      stream.next(m.message_data_len);
+
+      boost::shared_ptr<uint8_t[]> buf(new uint8_t[m.message_data_len]);
+      if(m.message_data_len > 0)
+      {
+        memcpy(buf.get(), stream.advance(m.message_data_len), m.message_data_len);
+      }
+      m.message_data = boost::shared_ptr<const uint8_t>(buf, buf.get());
+    }
+
+    inline static uint32_t serializedLength(const novatel_oem7_driver::Oem7RawMsgShared& m)
+    {
+      return serializationLength(m.header) + sizeof(m.message_data_len) + m.message_data_len;
+    }
+  };
+}
+}
+
+#endif
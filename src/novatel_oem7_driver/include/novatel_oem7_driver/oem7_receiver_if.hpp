@@ -28,6 +28,7 @@
 
 #include <ros/ros.h>
 #include <cstddef>
+#include <stdint.h>
 #include <boost/asio/buffer.hpp>
 
 
@@ -35,6 +36,20 @@
 
 namespace novatel_oem7_driver
 {
+  /**
+   * Arrival of receiver input.
+   */
+  struct Oem7InputArrival
+  {
+    ros::Time stamp;   ///< ROS time; zero: not known
+    int64_t   mono_ns; ///< Steady clock time, ns; used for latency measurement. 0: not known
+
+    Oem7InputArrival():
+      mono_ns(0)
+    {
+    }
+  };
+
   class Oem7ReceiverIf
   {
   public:
@@ -43,6 +58,15 @@ namespace novatel_oem7_driver
 
     virtual bool read( boost::asio::mutable_buffer, size_t&) = 0;
     virtual bool write(boost::asio::const_buffer           ) = 0;
+
+    /**
+     * @return arrival of the input returned by the latest read(), if the receiver buffered it;
+     * by default not known: the input arrived as it was read.
+     */
+    virtual Oem7InputArrival getReadArrival() const
+    {
+      return Oem7InputArrival();
+    }
   };
 }
 
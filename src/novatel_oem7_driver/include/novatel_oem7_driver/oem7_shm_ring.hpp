@@ -0,0 +1,573 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __OEM7_SHM_RING_HPP__
+#define __OEM7_SHM_RING_HPP__
+
+/*! \file
+ * Shared memory rings of decoded Oem7 messages, for consumers on the same host.
+ *
+ * Self-contained; does not depend on ROS. Consumers include this header and read with Oem7ShmRingReader.
+ *
+ * A ring is a POSIX shared memory object, /dev/shm/<name>, written by a single writer, the driver, and read by any
+ * number of readers, which never block the writer. Each slot holds one fixed-layout message struct, guarded by a
+ * sequence lock: readers copy the slot and check that the writer did not overwrite it meanwhile.
+ *
+ * Rings are named after the topic, see getOem7ShmName(); e.g. topic /novatel/oem7/inspva: /dev/shm/novatel.oem7.inspva.
+ *
+ * Example:
+ *   Oem7ShmRingReader<Oem7ShmINSPVA> inspva;
+ *   if(inspva.open(getOem7ShmName("/novatel/oem7/inspva")))
+ *   {
+ *     Oem7ShmINSPVA msg;
+ *     if(inspva.readLatest(msg))
+ *       ...
+ *   }
+ */
+
+#include <atomic>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <stdint.h>
+#include <cerrno>
+#include <ctime>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Common header of messages in shared memory; ROS header and Oem7 header fields.
+   */
+  struct Oem7ShmHeader
+  {
+    uint32_t seq;                   ///< ROS header seq
+    uint32_t stamp_sec;             ///< ROS header stamp
+    uint32_t stamp_nsec;
+    uint16_t gps_week_number;       ///< Oem7 header; 0 for messages without one, e.g. Imu
+    uint8_t  time_status;
+    uint8_t  reserved;
+    uint32_t gps_week_milliseconds;
+    char     frame_id[44];          ///< ROS header frame_id, nul-terminated; truncated if longer.
+  };
+
+  struct Oem7ShmBESTPOS
+  {
+    static const char* type() { return "BESTPOS"; }
+
+    Oem7ShmHeader header;
+    uint32_t sol_status;
+    uint32_t pos_type;
+    double   lat;
+    double   lon;
+    double   hgt;
+    float    undulation;
+    uint32_t datum_id;
+    float    lat_stdev;
+    float    lon_stdev;
+    float    hgt_stdev;
+    float    diff_age;
+    float    sol_age;
+    uint8_t  num_svs;
+    uint8_t  num_sol_svs;
+    uint8_t  num_sol_l1_svs;
+    uint8_t  num_sol_multi_svs;
+    uint8_t  ext_sol_stat;
+    uint8_t  galileo_beidou_sig_mask;
+    uint8_t  gps_glonass_sig_mask;
+    uint8_t  reserved;
+    uint32_t reserved2;
+  };
+
+  struct Oem7ShmINSPVA
+  {
+    static const char* type() { return "INSPVA"; }
+
+    Oem7ShmHeader header;
+    double   latitude;
+    double   longitude;
+    double   height;
+    double   north_velocity;
+    double   east_velocity;
+    double   up_velocity;
+    double   roll;
+    double   pitch;
+    double   azimuth;
+    uint32_t status;
+    uint32_t reserved;
+  };
+
+  struct Oem7ShmCORRIMU
+  {
+    static const char* type() { return "CORRIMU"; }
+
+    Oem7ShmHeader header;
+    uint32_t imu_data_count;
+    uint32_t reserved;
+    double   pitch_rate;
+    double   roll_rate;
+    double   yaw_rate;
+    double   lateral_acc;
+    double   longitudinal_acc;
+    double   vertical_acc;
+  };
+
+  /**
+   * sensor_msgs/Imu
+   */
+  struct Oem7ShmImu
+  {
+    static const char* type() { return "Imu"; }
+
+    Oem7ShmHeader header;
+    double orientation[4]; ///< x, y, z, w
+    double orientation_covariance[9];
+    double angular_velocity[3];
+    double angular_velocity_covariance[9];
+    double linear_acceleration[3];
+    double linear_acceleration_covariance[9];
+  };
+
+  // The layout is shared between processes, possibly built by different compilers: no implicit padding.
+  static_assert(sizeof(Oem7ShmHeader)  ==  64, "Oem7ShmHeader layout");
+  static_assert(sizeof(Oem7ShmBESTPOS) == 136, "Oem7ShmBESTPOS layout");
+  static_assert(sizeof(Oem7ShmINSPVA)  == 144, "Oem7ShmINSPVA layout");
+  static_assert(sizeof(Oem7ShmCORRIMU) == 120, "Oem7ShmCORRIMU layout");
+  static_assert(sizeof(Oem7ShmImu)     == 360, "Oem7ShmImu layout");
+
+  const uint32_t OEM7_SHM_MAGIC   = 0x374D454F; ///< "OEM7"
+  const uint32_t OEM7_SHM_VERSION = 1;
+
+  const size_t OEM7_SHM_CACHE_LINE = 64;
+
+  /**
+   * Ring header, at the start of the shared memory object. Slots follow, each on its own cache lines.
+   */
+  struct Oem7ShmRingHeader
+  {
+    uint32_t magic;
+    uint32_t version;
+    char     type[32];   ///< Message layout, e.g. "INSPVA"
+    uint32_t msg_size;   ///< sizeof the message layout
+    uint32_t num_slots;
+    uint32_t slot_size;  ///< Slot stride, bytes
+    int32_t  writer_pid; ///< Process writing the ring
+    std::atomic<uint64_t> write_count; ///< Messages written so far; message n is in slot n % num_slots.
+  };
+
+  /**
+   * Slot header. The slot holding message n is locked while seq == 2n + 1, and valid once seq == 2n + 2.
+   */
+  struct Oem7ShmSlotHeader
+  {
+    std::atomic<uint64_t> seq;
+  };
+
+  static_assert(sizeof(Oem7ShmRingHeader) == OEM7_SHM_CACHE_LINE, "Oem7ShmRingHeader layout");
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory rings require lock-free 64 bit atomics");
+
+  inline size_t getOem7ShmSlotSize(size_t msg_size)
+  {
+    const size_t size = sizeof(Oem7ShmSlotHeader) + msg_size;
+    return (size + OEM7_SHM_CACHE_LINE - 1) / OEM7_SHM_CACHE_LINE * OEM7_SHM_CACHE_LINE;
+  }
+
+  /**
+   * @return shared memory object name for a topic: '/', then the topic with '/' replaced by '.'.
+   */
+  inline std::string getOem7ShmName(const std::string& topic)
+  {
+    const size_t begin = topic.find_first_not_of('/');
+
+    std::string name = begin == std::string::npos ? "" : topic.substr(begin);
+    for(size_t i = 0; i < name.size(); i++)
+    {
+      if(name[i] == '/')
+        name[i] = '.';
+    }
+
+    return "/" + name;
+  }
+
+
+  /**
+   * Maps a shared memory object.
+   */
+  class Oem7ShmMapping
+  {
+  protected:
+    int    fd_;
+    size_t size_;
+    uint8_t* addr_;
+
+    Oem7ShmRingHeader* ring() const
+    {
+      return reinterpret_cast<Oem7ShmRingHeader*>(addr_);
+    }
+
+    Oem7ShmSlotHeader* slot(uint64_t n) const
+    {
+      return reinterpret_cast<Oem7ShmSlotHeader*>(addr_ + sizeof(Oem7ShmRingHeader) +
+                                                  (n % ring()->num_slots) * ring()->slot_size);
+    }
+
+    static uint8_t* data(Oem7ShmSlotHeader* slot)
+    {
+      return reinterpret_cast<uint8_t*>(slot) + sizeof(Oem7ShmSlotHeader);
+    }
+
+    bool map(int prot)
+    {
+      addr_ = static_cast<uint8_t*>(mmap(NULL, size_, prot, MAP_SHARED, fd_, 0));
+      if(addr_ == MAP_FAILED)
+      {
+        addr_ = NULL;
+        return false;
+      }
+
+      return true;
+    }
+
+  public:
+    Oem7ShmMapping():
+      fd_(-1),
+      size_(0),
+      addr_(NULL)
+    {
+    }
+
+    ~Oem7ShmMapping()
+    {
+      close();
+    }
+
+    void close()
+    {
+      if(addr_)
+      {
+        munmap(addr_, size_);
+        addr_ = NULL;
+      }
+
+      if(fd_ >= 0)
+      {
+        ::close(fd_);
+        fd_ = -1;
+      }
+    }
+
+    bool isOpen() const
+    {
+      return addr_ != NULL;
+    }
+
+  private:
+    Oem7ShmMapping(const Oem7ShmMapping&);
+    Oem7ShmMapping& operator=(const Oem7ShmMapping&);
+  };
+
+
+  /**
+   * Writes messages into a ring. Single writer.
+   */
+  class Oem7ShmRingWriter: public Oem7ShmMapping
+  {
+    std::string name_;
+    dev_t       dev_; ///< Identity of the object created, while name_ may since refer to another.
+    ino_t       ino_;
+
+    /**
+     * @return true if an existing ring is not written any more: its writer process is gone,
+     * or it never completed creating the ring.
+     */
+    static bool isStale(const std::string& name)
+    {
+      for(int attempt = 0; ; attempt++)
+      {
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if(fd < 0)
+          return errno == ENOENT; // Gone meanwhile.
+
+        pid_t pid = 0;
+        struct stat st;
+        if(fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(Oem7ShmRingHeader)))
+        {
+          void* addr = mmap(NULL, sizeof(Oem7ShmRingHeader), PROT_READ, MAP_SHARED, fd, 0);
+          if(addr != MAP_FAILED)
+          {
+            const Oem7ShmRingHeader* hdr = static_cast<const Oem7ShmRingHeader*>(addr);
+            if(hdr->magic == OEM7_SHM_MAGIC)
+            {
+              std::atomic_thread_fence(std::memory_order_acquire);
+              pid = hdr->writer_pid;
+            }
+            munmap(addr, sizeof(Oem7ShmRingHeader));
+          }
+        }
+        ::close(fd);
+
+        if(pid > 0)
+          return kill(pid, 0) != 0 && errno == ESRCH;
+
+        if(attempt == 10)
+          return true; // Still not initialized: its creator died.
+
+        const struct timespec delay = {0, 10 * 1000 * 1000}; // Creation may be in progress.
+        nanosleep(&delay, NULL);
+      }
+    }
+
+  public:
+    Oem7ShmRingWriter():
+      dev_(0),
+      ino_(0)
+    {
+    }
+
+    /**
+     * Closes the ring, and removes it unless its name was taken over by another ring meanwhile.
+     */
+    ~Oem7ShmRingWriter()
+    {
+      close();
+
+      if(name_.empty())
+        return;
+
+      const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+      if(fd >= 0)
+      {
+        struct stat st;
+        if(fstat(fd, &st) == 0 && st.st_dev == dev_ && st.st_ino == ino_)
+        {
+          shm_unlink(name_.c_str());
+        }
+        ::close(fd);
+      }
+    }
+
+    /**
+     * Creates the ring. A stale ring of the same name, left by a writer which is gone, is replaced; readers of the
+     * old ring must reopen it, see Oem7ShmRingReader::isStale().
+     *
+     * @return false on failure; errno is set: EEXIST if the ring exists and its writer is alive.
+     */
+    bool create(const std::string& name, const std::string& type, size_t msg_size, size_t num_slots)
+    {
+      fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+      if(fd_ < 0 && errno == EEXIST)
+      {
+        if(!isStale(name))
+        {
+          errno = EEXIST;
+          return false;
+        }
+
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+      }
+      if(fd_ < 0)
+        return false;
+
+      struct stat st;
+      if(fstat(fd_, &st) != 0)
+        return false;
+
+      name_ = name;
+      dev_  = st.st_dev;
+      ino_  = st.st_ino;
+
+      const size_t slot_size = getOem7ShmSlotSize(msg_size);
+      size_ = sizeof(Oem7ShmRingHeader) + num_slots * slot_size;
+      if(ftruncate(fd_, size_) != 0 || !map(PROT_READ | PROT_WRITE))
+        return false;
+
+      // Freshly truncated object is zero-filled: all slots are empty (seq 0).
+      Oem7ShmRingHeader* hdr = ring();
+      hdr->version    = OEM7_SHM_VERSION;
+      std::strncpy(hdr->type, type.c_str(), sizeof(hdr->type) - 1);
+      hdr->msg_size   = msg_size;
+      hdr->num_slots  = num_slots;
+      hdr->slot_size  = slot_size;
+      hdr->writer_pid = getpid();
+      hdr->write_count.store(0, std::memory_order_relaxed);
+
+      // Readers validate the header only once the magic is visible.
+      std::atomic_thread_fence(std::memory_order_release);
+      hdr->magic = OEM7_SHM_MAGIC;
+
+      return true;
+    }
+
+    /**
+     * Writes a message into the next slot, overwriting the oldest message.
+     */
+    void write(const void* msg)
+    {
+      Oem7ShmRingHeader* hdr = ring();
+
+      const uint64_t n = hdr->write_count.load(std::memory_order_relaxed);
+      Oem7ShmSlotHeader* s = slot(n);
+
+      s->seq.store(2 * n + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release); // Lock visible before any data.
+
+      std::memcpy(data(s), msg, hdr->msg_size);
+
+      s->seq.store(2 * n + 2, std::memory_order_release);
+      hdr->write_count.store(n + 1, std::memory_order_release);
+    }
+  };
+
+
+  /**
+   * Reads messages of layout T from a ring. Readers do not modify the ring; any number may read concurrently.
+   */
+  template <typename T>
+  class Oem7ShmRingReader: public Oem7ShmMapping
+  {
+  public:
+    enum Result
+    {
+      OK,
+      NOT_AVAILABLE, ///< Not written yet
+      OVERWRITTEN    ///< The writer has lapped the reader; the message is lost.
+    };
+
+    /**
+     * Opens an existing ring.
+     * @return false if the ring does not exist, or does not hold messages of layout T.
+     */
+    bool open(const std::string& name)
+    {
+      close();
+
+      fd_ = shm_open(name.c_str(), O_RDONLY, 0);
+      if(fd_ < 0)
+        return false;
+
+      struct stat st;
+      if(fstat(fd_, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Oem7ShmRingHeader)))
+      {
+        close();
+        return false;
+      }
+
+      size_ = st.st_size;
+      if(!map(PROT_READ))
+      {
+        close();
+        return false;
+      }
+
+      const Oem7ShmRingHeader* hdr = ring();
+      const bool initialized = hdr->magic == OEM7_SHM_MAGIC;
+      std::atomic_thread_fence(std::memory_order_acquire); // Header fields read after the magic.
+
+      const bool valid = initialized &&
+                         hdr->version  == OEM7_SHM_VERSION &&
+                         hdr->msg_size == sizeof(T) &&
+                         std::strncmp(hdr->type, T::type(), sizeof(hdr->type)) == 0 &&
+                         hdr->num_slots > 0 &&
+                         hdr->slot_size >= getOem7ShmSlotSize(sizeof(T)) &&
+                         size_ >= sizeof(Oem7ShmRingHeader) + static_cast<size_t>(hdr->num_slots) * hdr->slot_size;
+      if(!valid)
+      {
+        close();
+        return false;
+      }
+
+      return true;
+    }
+
+    /**
+     * @return true if the writer has since replaced the ring, e.g. on driver restart; reopen to continue reading.
+     */
+    bool isStale() const
+    {
+      struct stat st;
+      return fstat(fd_, &st) != 0 || st.st_nlink == 0;
+    }
+
+    /**
+     * @return number of messages written so far; the next message written will be number getWriteCount().
+     */
+    uint64_t getWriteCount() const
+    {
+      return ring()->write_count.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Reads message number n.
+     */
+    Result read(uint64_t n, T& msg) const
+    {
+      Oem7ShmSlotHeader* s = slot(n);
+
+      const uint64_t seq0 = s->seq.load(std::memory_order_acquire);
+      if(seq0 < 2 * n + 2) // Not written, or being written.
+        return NOT_AVAILABLE;
+      if(seq0 > 2 * n + 2)
+        return OVERWRITTEN;
+
+      std::memcpy(&msg, data(s), sizeof(T));
+
+      std::atomic_thread_fence(std::memory_order_acquire); // Data read before seq is checked again.
+      if(s->seq.load(std::memory_order_relaxed) != seq0)
+        return OVERWRITTEN;
+
+      return OK;
+    }
+
+    /**
+     * Reads the latest message.
+     * @return false if no message has been written yet.
+     */
+    bool readLatest(T& msg, uint64_t* n_out = NULL) const
+    {
+      for(;;)
+      {
+        const uint64_t count = getWriteCount();
+        if(count == 0)
+          return false;
+
+        if(read(count - 1, msg) == OK)
+        {
+          if(n_out)
+            *n_out = count - 1;
+
+          return true;
+        }
+        // Overwritten while reading; retry with a newer message.
+      }
+    }
+  };
+}
+
+#endif
@@ -31,17 +31,17 @@
 namespace novatel_oem7_driver
 {
 
-  uint32_t GetNextMsgSequenceNumber();
-
   template <typename T>
   void
   SetROSHeader(
       const std::string& frame_id,
+      const ros::Time& stamp,
+      uint32_t seq,
       boost::shared_ptr<T>& msg)
   {
     msg->header.frame_id = frame_id;
-    msg->header.stamp    = ros::Time::now();
-    msg->header.seq      = GetNextMsgSequenceNumber();
+    msg->header.stamp    = stamp;
+    msg->header.seq      = seq;
   }
 }
 #endif
@@ -43,13 +43,15 @@ namespace novatel_oem7_driver
   class ALIGNHandler: public Oem7MessageHandlerIf
   {
     Oem7RosPublisher HEADING2_pub_;
+    Oem7RosPublisher DUALANTENNAHEADING_pub_;
 
     void publishHEADING2(
-        Oem7RawMessageIf::ConstPtr msg)
+        Oem7RawMessageIf::ConstPtr msg,
+        Oem7RosPublisher& pub)
     {
       boost::shared_ptr<novatel_oem7_msgs::HEADING2> heading2;
       MakeROSMessage(msg, heading2);
-      HEADING2_pub_.publish(heading2);
+      pub.publish(heading2);
     }
 
   public:
@@ -64,11 +66,12 @@ namespace novatel_oem7_driver
     void initialize(ros::NodeHandle& nh)
     {
       HEADING2_pub_.setup<novatel_oem7_msgs::HEADING2>("HEADING2", nh);
+      DUALANTENNAHEADING_pub_.setup<novatel_oem7_msgs::HEADING2>("DUALANTENNAHEADING", nh);
     }
 
     const std::vector<int>& getMessageIds()
     {
-      static const std::vector<int> MSG_IDS({HEADING2_OEM7_MSGID});
+      static const std::vector<int> MSG_IDS({HEADING2_OEM7_MSGID, DUALANTENNAHEADING_OEM7_MSGID});
       return MSG_IDS;
     }
 
@@ -76,7 +79,14 @@ namespace novatel_oem7_driver
     {
       ROS_DEBUG_STREAM("ALIGN < [id= " <<  msg->getMessageId() << "]");
 
-      publishHEADING2(msg);
+      if(msg->getMessageId() == HEADING2_OEM7_MSGID)
+      {
+        publishHEADING2(msg, HEADING2_pub_);
+      }
+      else
+      {
+        publishHEADING2(msg, DUALANTENNAHEADING_pub_);
+      }
     }
   };
 }
@@ -31,6 +31,7 @@
 
 #include <novatel_oem7_driver/oem7_ros_messages.hpp>
 #include <oem7_ros_publisher.hpp>
+#include <oem7_ros_message_pool.hpp>
 
 #include "novatel_oem7_msgs/SolutionStatus.h"
 #include "novatel_oem7_msgs/PositionOrVelocityType.h"
@@ -46,8 +47,8 @@
 #include "geometry_msgs/Point.h"
 
 
-#include <tf2_geometry_msgs/tf2_geometry_msgs.h>
-#include <gps_common/conversions.h>
+#include <oem7_derived_state.hpp>
+#include <oem7_local_projection.hpp>
 
 #include <cmath>
 #include <stdint.h>
@@ -65,16 +66,6 @@ namespace novatel_oem7_driver
     return radians * 180.0 / M_PI;
   }
 
-  /***
-   * Converts degrees to Radians
-   *
-   * @return radians
-   */
-  inline double degreesToRadians(double degrees)
-  {
-    return degrees * M_PI / 180.0;
-  }
-
 
   /**
    * Compute a single 3D standard deviation from individual deviations.
@@ -269,21 +260,6 @@ namespace novatel_oem7_driver
     navsatfix->position_covariance_type = GpsFixCovTypeToNavSatFixCovType(gpsfix->position_covariance_type);
   }
 
-  /**
-   * Get Geometry (UTM) point from GNSS position, assuming zero origin.
-   */
-  void UTMPointFromGnss(
-          geometry_msgs::Point& pt,
-          double lat,
-          double lon,
-          double hgt)
-  {
-    pt.z = hgt;
-
-    std::string zone; //unused
-    gps_common::LLtoUTM(lat, lon, pt.x, pt.y, zone);
-  }
-
   /***
    * Handler of position-related messages. Synthesizes ROS messages GPSFix and NavSatFix from native Oem7 Messages.
    */
@@ -320,7 +296,7 @@ namespace novatel_oem7_driver
     bool position_source_BESTPOS_; //< User override: always use BESTPOS
     bool position_source_INS_; ///< User override: always use INS
 
-    tf2::Quaternion Z90_DEG_ROTATION; ///< Rotate ENU to ROS frames.
+    Oem7LocalProjection odometry_projection_; ///< Odometry position: UTM or local ENU
 
 
     /***
@@ -392,7 +368,7 @@ namespace novatel_oem7_driver
 
     void processPositionAndPublishGPSFix()
     {
-      gpsfix_.reset(new gps_common::GPSFix);
+      gpsfix_ = AllocROSMessage<gps_common::GPSFix>();
 
       gpsfix_->status.position_source     = gps_common::GPSStatus::SOURCE_NONE;
       gpsfix_->status.orientation_source  = gps_common::GPSStatus::SOURCE_NONE;
@@ -585,7 +561,7 @@ namespace novatel_oem7_driver
         return;
       }
 
-      boost::shared_ptr<sensor_msgs::NavSatFix> navsatfix(new sensor_msgs::NavSatFix);
+      boost::shared_ptr<sensor_msgs::NavSatFix> navsatfix = AllocROSMessage<sensor_msgs::NavSatFix>();
 
       // Derive from GPSFix.
       GpsFixToNavSatFix(gpsfix_, navsatfix);
@@ -595,16 +571,30 @@ namespace novatel_oem7_driver
 
     void publishOdometry()
     {
-      boost::shared_ptr<nav_msgs::Odometry> odometry(new nav_msgs::Odometry);
+      const bool enu = odometry_projection_.getMode() == Oem7LocalProjection::PROJECTION_ENU;
+      if(enu && !odometry_projection_.hasOrigin())
+      {
+        if(!gpsfix_ || gpsfix_->status.status == gps_common::GPSStatus::STATUS_NO_FIX)
+        {
+          return; // No position relative to the origin yet.
+        }
+
+        // First fix is the origin.
+        ROS_INFO_STREAM("Odometry ENU origin: " << gpsfix_->latitude  << " "
+                                                << gpsfix_->longitude << " "
+                                                << gpsfix_->altitude);
+      }
+
+      boost::shared_ptr<nav_msgs::Odometry> odometry = AllocROSMessage<nav_msgs::Odometry>();
       odometry->child_frame_id = base_frame_;
 
       if(gpsfix_)
       {
-        UTMPointFromGnss(
-            odometry->pose.pose.position,
+        odometry_projection_.project(
             gpsfix_->latitude,
             gpsfix_->longitude,
-            gpsfix_->altitude);
+            gpsfix_->altitude,
+            odometry->pose.pose.position);
 
         odometry->pose.covariance[ 0] = gpsfix_->position_covariance[0];
         odometry->pose.covariance[ 7] = gpsfix_->position_covariance[4];
@@ -616,20 +606,22 @@ namespace novatel_oem7_driver
         // INSPVA uses 'y-forward' ENU orientation;
         // ROS uses x-forward orientation.
 
-        odometry->twist.twist.linear.x = inspva_->north_velocity;
-        odometry->twist.twist.linear.y = inspva_->east_velocity;
+        if(enu) // Position axes: x east, y north.
+        {
+          odometry->twist.twist.linear.x = inspva_->east_velocity;
+          odometry->twist.twist.linear.y = inspva_->north_velocity;
+        }
+        else
+        {
+          odometry->twist.twist.linear.x = inspva_->north_velocity;
+          odometry->twist.twist.linear.y = inspva_->east_velocity;
+        }
         odometry->twist.twist.linear.z = inspva_->up_velocity;
 
-
-        tf2::Quaternion enu_orientation;
-        enu_orientation.setRPY(
-                          degreesToRadians(inspva_->roll),
-                         -degreesToRadians(inspva_->pitch),
-                         -degreesToRadians(inspva_->azimuth));
-
-        tf2::Quaternion ros_orientation = Z90_DEG_ROTATION * enu_orientation;
-
-        odometry->pose.pose.orientation = tf2::toMsg(ros_orientation);
+        odometry->pose.pose.orientation = Oem7DerivedStateCache::instance().getOrientation(
+                                                                              inspva_->roll,
+                                                                              inspva_->pitch,
+                                                                              inspva_->azimuth).ros;
       } // inspva_
 
 
@@ -639,8 +631,8 @@ namespace novatel_oem7_driver
         odometry->pose.covariance[28] = std::pow(inspvax_->pitch_stdev,     2);
         odometry->pose.covariance[35] = std::pow(inspvax_->azimuth_stdev,   2);
 
-        odometry->twist.covariance[0]  = std::pow(inspvax_->north_velocity_stdev, 2);
-        odometry->twist.covariance[7]  = std::pow(inspvax_->east_velocity_stdev,  2);
+        odometry->twist.covariance[0]  = std::pow(enu ? inspvax_->east_velocity_stdev  : inspvax_->north_velocity_stdev, 2);
+        odometry->twist.covariance[7]  = std::pow(enu ? inspvax_->north_velocity_stdev : inspvax_->east_velocity_stdev,  2);
         odometry->twist.covariance[14] = std::pow(inspvax_->up_velocity_stdev,    2);
       }
 
@@ -669,7 +661,6 @@ namespace novatel_oem7_driver
       position_source_BESTPOS_(false),
       position_source_INS_(false)
     {
-      Z90_DEG_ROTATION.setRPY(0, 0, degreesToRadians(90.0));
     }
 
     ~BESTPOSHandler()
@@ -690,7 +681,7 @@ namespace novatel_oem7_driver
 
       // Determine if position source is overriden by the user; otherwise it is determined dynamically.
       std::string position_source;
-      nh.getParam("position_source", position_source);
+      getOem7Param(nh, "position_source", position_source);
       if(position_source == "BESTPOS")
       {
         position_source_BESTPOS_ = true;
@@ -704,6 +695,32 @@ namespace novatel_oem7_driver
         position_source = "BESTPOS or INSPVAS based on quality";
       }
       ROS_INFO_STREAM("GPSFix position source: " << position_source);
+
+      // Odometry position: UTM, or ENU relative to a configured or first-fix origin.
+      std::string odometry_mode = "UTM";
+      getOem7Param(nh, "odometry_mode", odometry_mode);
+      if(odometry_mode == "ENU")
+      {
+        odometry_projection_.setMode(Oem7LocalProjection::PROJECTION_ENU);
+
+        std::vector<double> origin; // latitude, longitude, height
+        getOem7Param(nh, "odometry_enu_origin", origin);
+        if(origin.size() == 3)
+        {
+          odometry_projection_.setOrigin(origin[0], origin[1], origin[2]);
+          ROS_INFO_STREAM("Odometry ENU origin: " << origin[0] << " " << origin[1] << " " << origin[2]);
+        }
+        else if(!origin.empty())
+        {
+          ROS_ERROR_STREAM("Odometry ENU origin: [latitude, longitude, height] expected; using first fix.");
+        }
+      }
+      else if(odometry_mode != "UTM")
+      {
+        ROS_ERROR_STREAM("Odometry mode '" << odometry_mode << "' not supported; using UTM.");
+        odometry_mode = "UTM";
+      }
+      ROS_INFO_STREAM("Odometry mode: " << odometry_mode);
     }
 
     const std::vector<int>& getMessageIds()
@@ -27,7 +27,7 @@
 #include <ros/ros.h>
 
 
-#include <tf2_geometry_msgs/tf2_geometry_msgs.h>
+#include <oem7_derived_state.hpp>
 
 
 #include <novatel_oem7_driver/oem7_ros_messages.hpp>
@@ -36,12 +36,14 @@
 #include "novatel_oem7_msgs/CORRIMU.h"
 #include "novatel_oem7_msgs/IMURATECORRIMU.h"
 #include "novatel_oem7_msgs/INSSTDEV.h"
+#include "novatel_oem7_msgs/INSUPDATESTATUS.h"
 #include "novatel_oem7_msgs/INSCONFIG.h"
 #include "novatel_oem7_msgs/INSPVA.h"
 #include "novatel_oem7_msgs/INSPVAX.h"
 
 #include <boost/scoped_ptr.hpp>
 #include <oem7_ros_publisher.hpp>
+#include <oem7_ros_message_pool.hpp>
 
 #include <math.h>
 #include <map>
@@ -58,16 +60,6 @@ namespace
 
 namespace novatel_oem7_driver
 {
-  /***
-   * Converts degrees to Radians
-   *
-   * @return radians
-   */
-  inline double degreesToRadians(double degrees)
-  {
-    return degrees * M_PI / 180.0;
-  }
-
   const double DATA_NOT_AVAILABLE = -1.0; ///< Used to initialized unpopulated fields.
 
   class INSHandler: public Oem7MessageHandlerIf
@@ -79,6 +71,7 @@ namespace novatel_oem7_driver
     Oem7RosPublisher       insstdev_pub_;
     Oem7RosPublisher       inspvax_pub_;
     Oem7RosPublisher       insconfig_pub_;
+    Oem7RosPublisher       insupdatestatus_pub_;
 
     boost::shared_ptr<novatel_oem7_msgs::INSPVA>   inspva_;
     boost::shared_ptr<novatel_oem7_msgs::CORRIMU>  corrimu_;
@@ -95,7 +88,7 @@ namespace novatel_oem7_driver
     {
       std::string ns = ros::this_node::getNamespace();
       std::string param_name = ns + "/supported_imus/" + std::to_string(imu_type) + "/" + name;
-      if(!nh_.getParam(param_name, param))
+      if(!getOem7Param(nh_, param_name, param))
       {
         ROS_FATAL_STREAM("INS: IMU type= " << imu_type << " is not supported.");
       }
@@ -157,16 +150,14 @@ namespace novatel_oem7_driver
         return;
       }
 
-      boost::shared_ptr<sensor_msgs::Imu> imu(new sensor_msgs::Imu);
+      boost::shared_ptr<sensor_msgs::Imu> imu = AllocROSMessage<sensor_msgs::Imu>();
 
       if(inspva_)
       {
-        tf2::Quaternion tf_orientation;
-        tf_orientation.setRPY(
-                           degreesToRadians(inspva_->roll),
-                          -degreesToRadians(inspva_->pitch),
-                          -degreesToRadians(inspva_->azimuth));
-        imu->orientation = tf2::toMsg(tf_orientation);
+        imu->orientation = Oem7DerivedStateCache::instance().getOrientation(
+                                                                inspva_->roll,
+                                                                inspva_->pitch,
+                                                                inspva_->azimuth).enu;
       }
       else
       {
@@ -216,6 +207,14 @@ namespace novatel_oem7_driver
       insstdev_pub_.publish(insstdev_);
     }
 
+    void publishInsUpdateStatusMsg(Oem7RawMessageIf::ConstPtr msg)
+    {
+      boost::shared_ptr<novatel_oem7_msgs::INSUPDATESTATUS> insupdatestatus;
+      MakeROSMessage(msg, insupdatestatus);
+
+      insupdatestatus_pub_.publish(insupdatestatus);
+    }
+
 
   public:
     INSHandler():
@@ -236,8 +235,9 @@ namespace novatel_oem7_driver
       insstdev_pub_.setup< novatel_oem7_msgs::INSSTDEV>( "INSSTDEV",   nh);
       inspvax_pub_.setup<  novatel_oem7_msgs::INSPVAX>(  "INSPVAX",    nh);
       insconfig_pub_.setup<novatel_oem7_msgs::INSCONFIG>("INSCONFIG",  nh);
+      insupdatestatus_pub_.setup<novatel_oem7_msgs::INSUPDATESTATUS>("INSUPDATESTATUS", nh);
 
-      nh.getParam("imu_rate", imu_rate_); // User rate override
+      getOem7Param(nh, "imu_rate", imu_rate_); // User rate override
       if(imu_rate_ > 0)
       {
         ROS_INFO_STREAM("INS: IMU rate overriden to " << imu_rate_);
@@ -253,7 +253,8 @@ namespace novatel_oem7_driver
                                         INSPVAS_OEM7_MSGID,
                                         INSPVAX_OEM7_MSGID,
                                         INSSTDEV_OEM7_MSGID,
-                                        INSCONFIG_OEM7_MSGID
+                                        INSCONFIG_OEM7_MSGID,
+                                        INSUPDATESTATUS_OEM7_MSGID
                                       }
                                     );
       return MSG_IDS;
@@ -286,6 +287,10 @@ namespace novatel_oem7_driver
       {
         publishInsPVAXMsg(msg);
       }
+      else if(msg->getMessageId() == INSUPDATESTATUS_OEM7_MSGID)
+      {
+        publishInsUpdateStatusMsg(msg);
+      }
       else
       {
         assert(false);
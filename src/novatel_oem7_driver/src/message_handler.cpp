@@ -23,10 +23,14 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "message_handler.hpp"
+#include <oem7_param_cache.hpp>
+#include <oem7_startup.hpp>
 
 #include <pluginlib/class_loader.h>
 #include <pluginlib/class_list_macros.h>
 
+#include <future>
+
 
 
 namespace novatel_oem7_driver
@@ -39,43 +43,51 @@ namespace novatel_oem7_driver
   {
     // Load the plugins and create the dispatch table.
     std::vector<std::string> msg_handler_names;
-    nh.getParam("oem7_msg_handlers", msg_handler_names);
+    getOem7Param(nh, "oem7_msg_handlers", msg_handler_names);
     for(const auto& name : msg_handler_names)
     {
-      MessageHandlerShPtr msg_handler = msg_handler_loader_.createInstance(name);
+      msg_handlers_.push_back(createOem7Plugin(msg_handler_loader_, name));
+    }
 
-      msg_handler->initialize(nh);
+    // Initialize concurrently: handlers spend their initialization advertising topics, a master round trip each.
+    std::vector<std::future<void> > initialized;
+    for(const auto& msg_handler : msg_handlers_)
+    {
+      initialized.push_back(std::async(std::launch::async, [msg_handler, &nh](){ msg_handler->initialize(nh); }));
+    }
+    for(auto& init : initialized)
+    {
+      init.get(); // Rethrows initialization errors.
+    }
 
+    // Dispatch order is configuration order.
+    for(const auto& msg_handler : msg_handlers_)
+    {
       for(int msg_id: msg_handler->getMessageIds())
       {
-        MessageHandlerMap::iterator itr = msg_handler_map_.find(msg_id);
-        if(itr == msg_handler_map_.end())
-        {
-          msg_handler_map_[msg_id].reset(new MsgHandlerList);
-        }
-
-        msg_handler_map_[msg_id]->push_back(msg_handler);
+        msg_dispatch_table_.add(msg_id, msg_handler.get());
       }
     }
+
+    msg_dispatch_table_.build();
   }
 
   /**
    * Dispatches raw messages to plugins for decoding.
    */
-  void MessageHandler::handleMessage(Oem7RawMessageIf::ConstPtr raw_msg)
+  void MessageHandler::handleMessage(const Oem7RawMessageIf::ConstPtr& raw_msg)
   {
-    MessageHandlerMap::iterator itr = msg_handler_map_.find(raw_msg->getMessageId());
-    if(itr == msg_handler_map_.end())
+    const Oem7DispatchTable<Oem7MessageHandlerIf*>::Span handlers =
+                                                  msg_dispatch_table_.lookup(raw_msg->getMessageId());
+    if(handlers.empty())
     {
       ROS_DEBUG_STREAM("No handler for message ID= " <<  raw_msg->getMessageId());
       return;
     }
 
-    MessageHandlerListPtr& msg_handler_list = itr->second;
-    for(auto& h: *msg_handler_list)
+    for(Oem7MessageHandlerIf* h: handlers)
     {
       h->handleMsg(raw_msg);
     }
   }
 }
-
@@ -36,7 +36,9 @@ using novatel_oem7::Oem7RawMessageIf;
 #include "novatel_oem7_driver/oem7_message_decoder_if.hpp"
 #include "novatel_oem7_driver/oem7_message_handler_if.hpp"
 
-#include <boost/scoped_ptr.hpp>
+#include <oem7_dispatch_table.hpp>
+
+#include <vector>
 
 namespace novatel_oem7_driver
 {
@@ -49,15 +51,14 @@ namespace novatel_oem7_driver
     pluginlib::ClassLoader<novatel_oem7_driver::Oem7MessageHandlerIf> msg_handler_loader_; ///< Plugin loader
 
     typedef boost::shared_ptr<novatel_oem7_driver::Oem7MessageHandlerIf> MessageHandlerShPtr;
-    typedef std::list<MessageHandlerShPtr> MsgHandlerList;
-    typedef boost::scoped_ptr<MsgHandlerList> MessageHandlerListPtr;
-    typedef std::map<int, MessageHandlerListPtr> MessageHandlerMap;
-    MessageHandlerMap msg_handler_map_; ///< Dispatch map for raw messages.
+    std::vector<MessageHandlerShPtr> msg_handlers_; ///< Owns the loaded plugins.
+
+    Oem7DispatchTable<Oem7MessageHandlerIf*> msg_dispatch_table_; ///< Dispatch table for raw messages.
 
   public:
     MessageHandler(ros::NodeHandle& nh);
 
-    void handleMessage(Oem7RawMessageIf::ConstPtr raw_msg);
+    void handleMessage(const Oem7RawMessageIf::ConstPtr& raw_msg);
   };
 }
 
@@ -25,6 +25,7 @@
 #include <novatel_oem7_driver/oem7_message_handler_if.hpp>
 
 #include <oem7_ros_publisher.hpp>
+#include <oem7_ros_message_pool.hpp>
 
 #include <ros/ros.h>
 
@@ -41,7 +42,7 @@ namespace novatel_oem7_driver
 
     void publishNMEASentence(Oem7RawMessageIf::ConstPtr msg)
     {
-      boost::shared_ptr<nmea_msgs::Sentence> nmea_sentence(new nmea_msgs::Sentence);
+      boost::shared_ptr<nmea_msgs::Sentence> nmea_sentence = AllocROSMessage<nmea_msgs::Sentence>();
       nmea_sentence->sentence.assign(reinterpret_cast<const char*>(msg->getMessageData(0)), msg->getMessageDataLength());
       NMEA_pub_.publish(nmea_sentence);
     }
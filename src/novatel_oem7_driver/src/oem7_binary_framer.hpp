@@ -0,0 +1,336 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_BINARY_FRAMER_HPP__
+#define __OEM7_BINARY_FRAMER_HPP__
+
+#include <oem7_raw_message_if.hpp>
+#include <novatel_oem7_driver/oem7_messages.h>
+
+#include <oem7_crc32.hpp>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Receiver input; Oem7 binary messages framed in it refer to it, and keep it alive.
+   */
+  struct Oem7FrameChunk
+  {
+    static const size_t SIZE = 128 * 1024; ///< Holds the longest Oem7 binary message, and more.
+
+    std::vector<uint8_t> data;
+
+    Oem7FrameChunk():
+      data(SIZE)
+    {
+    }
+  };
+
+  /**
+   * Oem7 binary or short binary message: a view of the receiver input it was framed in, including header and CRC.
+   */
+  class Oem7BinaryFrame: public novatel_oem7::Oem7RawMessageIf
+  {
+    boost::shared_ptr<const Oem7FrameChunk> chunk_;
+
+    const uint8_t*  data_;
+    size_t          len_;
+    int             id_;
+    Oem7MessageType type_;
+
+  public:
+    Oem7BinaryFrame(
+        const boost::shared_ptr<const Oem7FrameChunk>& chunk,
+        const uint8_t* data,
+        size_t len,
+        int id,
+        Oem7MessageType type):
+      chunk_(chunk),
+      data_(data),
+      len_(len),
+      id_(id),
+      type_(type)
+    {
+    }
+
+    Oem7MessageType getMessageType() const
+    {
+      return type_;
+    }
+
+    Oem7MessageFormat getMessageFormat() const
+    {
+      return OEM7MSGFMT_BINARY;
+    }
+
+    int getMessageId() const
+    {
+      return id_;
+    }
+
+    const uint8_t* getMessageData(size_t offset) const
+    {
+      return data_ + offset;
+    }
+
+    size_t getMessageDataLength() const
+    {
+      return len_;
+    }
+  };
+
+
+  /**
+   * Frames Oem7 binary and short binary messages in receiver input, without copying them.
+   *
+   * Input is read into large chunks; framed messages are views into a chunk. Only the unframed tail of a chunk, the
+   * beginning of a message continued in the next read, is copied into the next chunk. Chunks no longer referred to
+   * by messages are reused.
+   *
+   * Input which is not part of a binary message with a valid CRC, e.g. ASCII responses and logs, is passed through
+   * to the user, in order.
+   */
+  class Oem7BinaryFramer
+  {
+  public:
+    enum Result
+    {
+      FRAME,       ///< A binary message was framed
+      PASSTHROUGH, ///< Input not framed as binary
+      NEED_INPUT   ///< All input consumed, or the message at the end of it is incomplete
+    };
+
+    static const size_t MIN_READ_SIZE = 16 * 1024; ///< Smaller space left in a chunk starts a new one.
+    static const size_t MAX_RETIRED   = 64;        ///< Retired chunks kept for reuse.
+
+    static const size_t CRC_LEN = sizeof(uint32_t);
+
+  private:
+    boost::shared_ptr<Oem7FrameChunk> chunk_;       ///< Current chunk
+    size_t                            pos_;         ///< Start of the unscanned input
+    size_t                            end_;         ///< End of the input read
+
+    std::vector<boost::shared_ptr<Oem7FrameChunk> > retired_; ///< Earlier chunks, some still referred to.
+
+    uint64_t num_frames_;
+    uint64_t num_crc_errors_;
+    uint64_t num_passthrough_bytes_;
+
+
+    boost::shared_ptr<Oem7FrameChunk> acquireChunk()
+    {
+      for(size_t i = 0; i < retired_.size(); i++)
+      {
+        if(retired_[i].use_count() == 1)
+        {
+          std::atomic_thread_fence(std::memory_order_acquire); // Readers on other threads are done.
+
+          boost::shared_ptr<Oem7FrameChunk> chunk;
+          chunk.swap(retired_[i]);
+          retired_[i].swap(retired_.back());
+          retired_.pop_back();
+          return chunk;
+        }
+      }
+
+      return boost::make_shared<Oem7FrameChunk>();
+    }
+
+    Result passthrough(const uint8_t* begin, size_t len, const uint8_t*& pass, size_t& pass_len)
+    {
+      pass     = begin;
+      pass_len = len;
+      pos_    += len;
+      num_passthrough_bytes_ += len;
+      return PASSTHROUGH;
+    }
+
+  public:
+    Oem7BinaryFramer():
+      chunk_(boost::make_shared<Oem7FrameChunk>()),
+      pos_(0),
+      end_(0),
+      num_frames_(0),
+      num_crc_errors_(0),
+      num_passthrough_bytes_(0)
+    {
+    }
+
+    /**
+     * @return buffer for the next read of receiver input; followed by commit().
+     */
+    boost::asio::mutable_buffer prepare()
+    {
+      const size_t tail = end_ - pos_;
+
+      if(chunk_.use_count() == 1) // No messages refer to the chunk; reuse it.
+      {
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        memmove(chunk_->data.data(), chunk_->data.data() + pos_, tail);
+        pos_ = 0;
+        end_ = tail;
+      }
+      else if(Oem7FrameChunk::SIZE - end_ < MIN_READ_SIZE)
+      {
+        boost::shared_ptr<Oem7FrameChunk> chunk = acquireChunk();
+        memcpy(chunk->data.data(), chunk_->data.data() + pos_, tail);
+
+        if(retired_.size() < MAX_RETIRED)
+        {
+          retired_.push_back(chunk_);
+        }
+        chunk_ = chunk;
+        pos_   = 0;
+        end_   = tail;
+      }
+
+      return boost::asio::buffer(chunk_->data.data() + end_, Oem7FrameChunk::SIZE - end_);
+    }
+
+    /**
+     * Input of the given length was read into the buffer obtained from prepare().
+     */
+    void commit(size_t len)
+    {
+      end_ += len;
+    }
+
+    /**
+     * Frames the next binary message in the input, or obtains the input preceding it.
+     *
+     * @return FRAME: the message is in frame; PASSTHROUGH: the input in pass, pass_len is not binary;
+     *         NEED_INPUT: more input is needed.
+     */
+    Result next(
+        novatel_oem7::Oem7RawMessageIf::ConstPtr& frame,
+        const uint8_t*& pass,
+        size_t& pass_len)
+    {
+      if(pos_ == end_)
+      {
+        return NEED_INPUT;
+      }
+
+      const uint8_t* begin = chunk_->data.data() + pos_;
+      const size_t   avail = end_ - pos_;
+
+      // Sync: 0xAA 0x44 0x12 (binary) or 0x13 (short binary); memchr is vectorized.
+      const uint8_t* sync = static_cast<const uint8_t*>(memchr(begin, 0xAA, avail));
+      if(!sync)
+      {
+        return passthrough(begin, avail, pass, pass_len);
+      }
+      if(sync != begin)
+      {
+        return passthrough(begin, sync - begin, pass, pass_len);
+      }
+
+      if(avail < 3)
+      {
+        return NEED_INPUT;
+      }
+      if(begin[1] != 0x44 || (begin[2] != 0x12 && begin[2] != 0x13))
+      {
+        return passthrough(begin, 1, pass, pass_len);
+      }
+
+      size_t len;
+      novatel_oem7::Oem7RawMessageIf::Oem7MessageType type = novatel_oem7::Oem7RawMessageIf::OEM7MSGTYPE_LOG;
+      if(begin[2] == 0x12)
+      {
+        if(avail < OEM7_BINARY_MSG_HDR_LEN)
+        {
+          return NEED_INPUT;
+        }
+
+        // Header must be as expected; anything else is left to the user.
+        const Oem7MessageHeaderMem* hdr = reinterpret_cast<const Oem7MessageHeaderMem*>(begin);
+        if(hdr->header_length != OEM7_BINARY_MSG_HDR_LEN || (hdr->message_type & 0x60) != 0) // Format: binary
+        {
+          return passthrough(begin, 1, pass, pass_len);
+        }
+
+        len = hdr->header_length + hdr->message_length + CRC_LEN;
+        if(hdr->message_type & 0x80)
+        {
+          type = novatel_oem7::Oem7RawMessageIf::OEM7MSGTYPE_RSP;
+        }
+      }
+      else
+      {
+        if(avail < OEM7_BINARY_MSG_SHORT_HDR_LEN)
+        {
+          return NEED_INPUT;
+        }
+
+        len = OEM7_BINARY_MSG_SHORT_HDR_LEN + begin[3] + CRC_LEN;
+      }
+
+      if(avail < len)
+      {
+        return NEED_INPUT;
+      }
+
+      if(Oem7CRC32(begin, len) != 0) // The CRC of a message followed by its CRC is 0.
+      {
+        num_crc_errors_++;
+        return passthrough(begin, 1, pass, pass_len); // Resync past this sync.
+      }
+
+      const int id = reinterpret_cast<const Oem7MessageCommonHeaderMem*>(begin)->message_id;
+      frame = boost::make_shared<Oem7BinaryFrame>(chunk_, begin, len, id, type);
+
+      pos_ += len;
+      num_frames_++;
+      return FRAME;
+    }
+
+    uint64_t getNumFrames() const
+    {
+      return num_frames_;
+    }
+
+    uint64_t getNumCRCErrors() const
+    {
+      return num_crc_errors_;
+    }
+
+    uint64_t getNumPassthroughBytes() const
+    {
+      return num_passthrough_bytes_;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __OEM7_COMMAND_ENGINE_HPP__
+#define __OEM7_COMMAND_ENGINE_HPP__
+
+#include <ros/ros.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Issues Oem7 Abbreviated ASCII commands, keeping up to 'window' commands outstanding at a time.
+   *
+   * The receiver executes the commands from a port in order, and abbreviated responses do not identify
+   * their command: responses are correlated with the outstanding commands in order of issue.
+   * Each command has its own timeout; a command without a response is issued again, after the commands already
+   * outstanding. Configuration commands are idempotent, so duplicates are harmless.
+   *
+   * The receiver responds to every command it reads, if only with an error; so a missing response was lost on the way
+   * back, and its command was executed. A lost response shifts the correlation of the responses following it, until the
+   * newest outstanding command times out. So after a timeout, no command is issued until all outstanding commands
+   * have completed or timed out; then commands are issued one at a time, until one of them gets its response.
+   *
+   * Thread safe: any number of threads may issue commands concurrently; responses are reported from the decoder thread.
+   */
+  class Oem7CommandEngine
+  {
+  public:
+    typedef std::function<void(const std::string&)> WriteFn; ///< Writes a command to the receiver.
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Command
+    {
+      std::string cmd;
+      std::string rsp;      ///< Empty if the command failed.
+      int         attempts;
+      bool        done;
+    };
+
+    struct Outstanding
+    {
+      Command*          cmd;
+      Clock::time_point deadline;
+      bool              alone;    ///< Issued with no other command outstanding.
+    };
+
+    const std::string name_; ///< For log output.
+    const WriteFn     write_;
+
+    const size_t          window_;       ///< Max outstanding commands
+    const Clock::duration timeout_;      ///< Per command attempt
+    const int             max_attempts_;
+
+    std::mutex write_mtx_;  ///< Serializes writes: commands are written in the order they become outstanding.
+
+    std::mutex              mtx_;       ///< Guards command state.
+    std::condition_variable done_cond_; ///< A command completed, or the window opened.
+    std::deque<Command*>    pending_;   ///< Not issued yet.
+    std::deque<Outstanding> outstanding_; ///< Issued, awaiting response; in order of issue.
+    bool                    resync_;      ///< Responses may be misattributed after a timeout: issue one at a time.
+
+    uint64_t num_timeouts_;
+    uint64_t num_unsolicited_;
+
+    /**
+     * Issues a command again, if it has attempts left; mtx_ held.
+     */
+    void retry(Command* cmd)
+    {
+      if(cmd->attempts < max_attempts_)
+      {
+        pending_.push_front(cmd);
+      }
+      else
+      {
+        cmd->done = true;
+        done_cond_.notify_all();
+      }
+    }
+
+    /**
+     * Retires timed out commands; mtx_ held.
+     * Commands become outstanding in deadline order: only the oldest ones can time out.
+     */
+    void expire(Clock::time_point now)
+    {
+      while(!outstanding_.empty() && outstanding_.front().deadline <= now)
+      {
+        Command* cmd = outstanding_.front().cmd;
+        outstanding_.pop_front();
+        num_timeouts_++;
+        resync_ = true;
+
+        ROS_ERROR_STREAM(name_ << ": AACmd '" << cmd->cmd << "': attempt " << cmd->attempts
+                               << ": timed out waiting for response.");
+
+        retry(cmd);
+      }
+    }
+
+    /**
+     * Retires timed out commands, and issues pending commands while the window allows.
+     */
+    void pump()
+    {
+      std::lock_guard<std::mutex> write_lk(write_mtx_);
+
+      for(;;)
+      {
+        Command* cmd = NULL;
+        {
+          std::lock_guard<std::mutex> lk(mtx_);
+
+          const Clock::time_point now = Clock::now();
+          expire(now);
+
+          const size_t window = resync_ ? 1 : window_; // Resync: drain the window first.
+          if(pending_.empty() || outstanding_.size() >= window)
+            return;
+
+          cmd = pending_.front();
+          pending_.pop_front();
+
+          cmd->attempts++;
+          Outstanding outstanding = {cmd, now + timeout_, outstanding_.empty()};
+          outstanding_.push_back(outstanding); // Before writing: the response may arrive before write_ returns.
+        }
+
+        write_(cmd->cmd);
+      }
+    }
+
+  public:
+    Oem7CommandEngine(
+        const std::string& name,
+        const WriteFn&     write,
+        size_t             window,       ///< Max outstanding commands
+        double             timeout_sec,  ///< Per command attempt
+        int                max_attempts
+        ):
+      name_(name),
+      write_(write),
+      window_(std::max<size_t>(window, 1)),
+      timeout_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timeout_sec))),
+      max_attempts_(std::max(max_attempts, 1)),
+      resync_(false),
+      num_timeouts_(0),
+      num_unsolicited_(0)
+    {
+    }
+
+    /**
+     * Issues commands, pipelined, and waits for all of them to complete.
+     * Commands are issued in order; each may be issued again after a timeout.
+     *
+     * @param rsps The response to each command; empty if there was none.
+     */
+    void execute(const std::vector<std::string>& cmds, std::vector<std::string>& rsps)
+    {
+      std::vector<Command> batch(cmds.size());
+      {
+        std::lock_guard<std::mutex> lk(mtx_);
+        for(size_t i = 0; i < cmds.size(); i++)
+        {
+          batch[i].cmd      = cmds[i];
+          batch[i].attempts = 0;
+          batch[i].done     = false;
+          pending_.push_back(&batch[i]);
+        }
+      }
+
+      // Waiting threads drive issuing and timeouts.
+      for(size_t num_done = 0;;)
+      {
+        pump();
+
+        std::unique_lock<std::mutex> lk(mtx_);
+        while(num_done < batch.size() && batch[num_done].done)
+        {
+          num_done++;
+        }
+        if(num_done == batch.size())
+          break;
+
+        // Not done: some command is still pending or outstanding; pump() left none pending unless the window is full.
+        const Clock::time_point deadline = outstanding_.empty() ? Clock::now() + timeout_ : outstanding_.front().deadline;
+        done_cond_.wait_until(lk, deadline);
+      }
+
+      rsps.resize(batch.size());
+      for(size_t i = 0; i < batch.size(); i++)
+      {
+        rsps[i].swap(batch[i].rsp);
+      }
+    }
+
+    /**
+     * Issues a single command, and waits for its response.
+     * @return the response; empty if there was none.
+     */
+    std::string execute(const std::string& cmd)
+    {
+      std::vector<std::string> rsps;
+      execute(std::vector<std::string>(1, cmd), rsps);
+      return rsps[0];
+    }
+
+    /**
+     * Reports a response from the receiver; completes the oldest outstanding command.
+     */
+    void onResponse(const std::string& rsp)
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+
+      if(outstanding_.empty())
+      {
+        num_unsolicited_++;
+        ROS_WARN_STREAM(name_ << ": Unsolicited response: '" << rsp << "'");
+        return;
+      }
+
+      Command* cmd = outstanding_.front().cmd;
+      if(outstanding_.front().alone)
+      {
+        resync_ = false; // Response to the only command outstanding: correlated again.
+      }
+      outstanding_.pop_front();
+
+      cmd->rsp  = rsp;
+      cmd->done = true;
+      done_cond_.notify_all(); // Also opens the window.
+    }
+
+    /**
+     * Reports a response which could not be read; the oldest outstanding command is issued again.
+     */
+    void onCorruptResponse()
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+
+      if(outstanding_.empty())
+        return;
+
+      Command* cmd = outstanding_.front().cmd;
+      outstanding_.pop_front();
+
+      retry(cmd);
+      done_cond_.notify_all(); // Opens the window.
+    }
+
+    uint64_t getNumTimeouts()
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      return num_timeouts_;
+    }
+
+    uint64_t getNumUnsolicited()
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      return num_unsolicited_;
+    }
+  };
+}
+
+#endif
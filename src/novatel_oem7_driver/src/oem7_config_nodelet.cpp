@@ -25,12 +25,13 @@
 #include <ros/ros.h>
 #include <nodelet/nodelet.h>
 
-#include "novatel_oem7_msgs/Oem7AbasciiCmd.h"
+#include "novatel_oem7_msgs/Oem7AbasciiCmdBatch.h"
 
 #include <algorithm>
 
 namespace
 {
+   const std::string CMD_PAUSE("!PAUSE");
 
    /**
     * @return true if the string has the specified prefix
@@ -47,13 +48,13 @@ namespace novatel_oem7_driver
 {
   /**
    * Nodelet which configures Oem7 receiver.
-   * Sends Oem7 commands using 'Oem7Cmd' service. The commands are obtained from Global parameters.
-   *
+   * Sends Oem7 commands using 'Oem7CmdBatch' service. The commands are obtained from Global parameters.
+   * Commands between driver-internal commands, like PAUSE, are sent as one batch, pipelined by the driver.
    */
   class Oem7ConfigNodelet : public nodelet::Nodelet
   {
     ros::Timer serviceCbTimer_; /**< Timer used to execute main service callback. */
-    ros::ServiceClient client_; /** Oem7Cmd service */
+    ros::ServiceClient client_; /** Oem7CmdBatch service */
 
   public:
 
@@ -65,13 +66,13 @@ namespace novatel_oem7_driver
         NODELET_INFO_STREAM(getName() << ": Oem7ConfigNodelet v." << novatel_oem7_driver_VERSION << "; "
                                       << __DATE__ << " " << __TIME__);
 
-        client_ = getNodeHandle().serviceClient<novatel_oem7_msgs::Oem7AbasciiCmd>("Oem7Cmd");
+        client_ = getNodeHandle().serviceClient<novatel_oem7_msgs::Oem7AbasciiCmdBatch>("Oem7CmdBatch");
 
         serviceCbTimer_ = getNodeHandle().createTimer(ros::Duration(0.0), &Oem7ConfigNodelet::serviceLoopCb, this, true);
       }
 
       /**
-       * Service loop, obtains and sends the configuration commands sequentially, waiting for a response from a previous command before sending the next one.
+       * Service loop, obtains and sends the configuration commands; waits for the responses to each batch before sending the next one.
        */
       void serviceLoopCb(const ros::TimerEvent& event)
       {
@@ -79,24 +80,26 @@ namespace novatel_oem7_driver
 
         std::vector<std::string> receiver_init_commands;
         getNodeHandle().getParam("receiver_init_commands", receiver_init_commands);
-        for(const auto& cmd : receiver_init_commands)
-        {
-          issueConfigCmd(cmd);
-        }
+        issueConfigCmds(receiver_init_commands);
 
         NODELET_INFO_STREAM("Oem7 extended initialization commands:");
 
         std::vector<std::string> receiver_ext_init_commands;
         getNodeHandle().getParam("receiver_ext_init_commands", receiver_ext_init_commands);
-        for(const auto& cmd : receiver_ext_init_commands)
-        {
-          issueConfigCmd(cmd);
-        }
+        issueConfigCmds(receiver_ext_init_commands);
 
         NODELET_INFO_STREAM("Oem7 configuration completed.");
         client_.shutdown();
       }
 
+      /**
+       * @return true when the provided command is a recongized internal command.
+       */
+      bool isInternalCommand(const std::string& cmd)
+      {
+        return isPrefix(CMD_PAUSE, cmd);
+      }
+
       /**
        * Executes Driver-specific command, like PAUSE.
        *
@@ -104,7 +107,6 @@ namespace novatel_oem7_driver
        */
       bool executeInternalCommand(const std::string& cmd)
       {
-        static const std::string CMD_PAUSE("!PAUSE");
    	if(isPrefix(CMD_PAUSE, cmd))
         {
            std::stringstream ss(cmd);
@@ -132,23 +134,62 @@ namespace novatel_oem7_driver
       }
 
       /**
-       * Issues Oem7 configuration command
+       * Issues Oem7 configuration commands, in order. Oem7 commands are batched up to the next internal command.
        */
-      void issueConfigCmd(const std::string& cmd /**< The command to issue */)
+      void issueConfigCmds(const std::vector<std::string>& cmds /**< The commands to issue */)
       {
-        if(!executeInternalCommand(cmd))
+        std::vector<std::string> batch;
+        for(const auto& cmd : cmds)
         {
-           novatel_oem7_msgs::Oem7AbasciiCmd oem7_cmd;
-           oem7_cmd.request.cmd = cmd;
+          if(isInternalCommand(cmd))
+          {
+            issueConfigBatch(batch);
+            batch.clear();
+
+            executeInternalCommand(cmd);
+          }
+          else
+          {
+            batch.push_back(cmd);
+          }
+        }
 
-           if(client_.call(oem7_cmd)) // BLOCKS with no timeout.
-           {
-              NODELET_DEBUG_STREAM("Config: '" <<  cmd << "' : Rsp: '" << oem7_cmd.response.rsp << "'");
-           }
-           else
-           {
-              NODELET_ERROR_STREAM("Config '" << cmd << "' not executed.");
-           }
+        issueConfigBatch(batch);
+      }
+
+      /**
+       * Issues a batch of Oem7 configuration commands; the driver pipelines them.
+       */
+      void issueConfigBatch(const std::vector<std::string>& cmds /**< The commands to issue */)
+      {
+        if(cmds.empty())
+        {
+          return;
+        }
+
+        novatel_oem7_msgs::Oem7AbasciiCmdBatch oem7_cmds;
+        oem7_cmds.request.cmds = cmds;
+
+        if(client_.call(oem7_cmds) && oem7_cmds.response.rsps.size() == cmds.size()) // BLOCKS with no timeout.
+        {
+          for(size_t i = 0; i < cmds.size(); i++)
+          {
+            if(oem7_cmds.response.rsps[i].empty())
+            {
+              NODELET_ERROR_STREAM("Config '" << cmds[i] << "' not executed.");
+            }
+            else
+            {
+              NODELET_DEBUG_STREAM("Config: '" <<  cmds[i] << "' : Rsp: '" << oem7_cmds.response.rsps[i] << "'");
+            }
+          }
+        }
+        else
+        {
+          for(const auto& cmd : cmds)
+          {
+            NODELET_ERROR_STREAM("Config '" << cmd << "' not executed.");
+          }
         }
       }
   };
@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <oem7_crc32.hpp>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define OEM7_CRC32_PCLMUL
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+
+namespace novatel_oem7_driver
+{
+  namespace
+  {
+    /**
+     * Lookup tables: table[0] is the bytewise table; table[k] advances a byte through k further zero bytes.
+     */
+    struct Oem7CRC32Tables
+    {
+      uint32_t table[8][256];
+
+      Oem7CRC32Tables()
+      {
+        for(uint32_t i = 0; i < 256; i++)
+        {
+          uint32_t crc = i;
+          for(int b = 0; b < 8; b++)
+          {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+          }
+          table[0][i] = crc;
+        }
+
+        for(uint32_t i = 0; i < 256; i++)
+        {
+          for(int k = 1; k < 8; k++)
+          {
+            table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+          }
+        }
+      }
+
+      static const Oem7CRC32Tables& instance()
+      {
+        static const Oem7CRC32Tables tables;
+        return tables;
+      }
+    };
+
+
+    typedef uint32_t (*Oem7CRC32Fn)(const uint8_t*, size_t, uint32_t);
+
+    struct Oem7CRC32Impl
+    {
+      Oem7CRC32Fn fn;
+      const char* name;
+
+      Oem7CRC32Impl()
+      {
+        if(isOem7CRC32PCLMULSupported())
+        {
+          fn   = Oem7CRC32PCLMUL;
+          name = "PCLMUL";
+        }
+        else
+        {
+          fn   = Oem7CRC32Slice8;
+          name = "slice-by-8";
+        }
+      }
+
+      static const Oem7CRC32Impl& instance()
+      {
+        static const Oem7CRC32Impl impl;
+        return impl;
+      }
+    };
+  }
+
+
+  uint32_t Oem7CRC32(const uint8_t* data, size_t len, uint32_t crc)
+  {
+    return Oem7CRC32Impl::instance().fn(data, len, crc);
+  }
+
+  const char* getOem7CRC32Name()
+  {
+    return Oem7CRC32Impl::instance().name;
+  }
+
+  uint32_t Oem7CRC32Bytewise(const uint8_t* data, size_t len, uint32_t crc)
+  {
+    const uint32_t (&t)[256] = Oem7CRC32Tables::instance().table[0];
+
+    for(size_t i = 0; i < len; i++)
+    {
+      crc = t[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+  }
+
+  uint32_t Oem7CRC32Slice8(const uint8_t* data, size_t len, uint32_t crc)
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const uint32_t (*t)[256] = Oem7CRC32Tables::instance().table;
+
+    for(; len >= 8; data += 8, len -= 8)
+    {
+      uint32_t lo, hi;
+      memcpy(&lo, data,     sizeof(lo));
+      memcpy(&hi, data + 4, sizeof(hi));
+      lo ^= crc;
+
+      crc = t[7][ lo        & 0xFF] ^ t[6][(lo >>  8) & 0xFF] ^
+            t[5][(lo >> 16) & 0xFF] ^ t[4][ lo >> 24        ] ^
+            t[3][ hi        & 0xFF] ^ t[2][(hi >>  8) & 0xFF] ^
+            t[1][(hi >> 16) & 0xFF] ^ t[0][ hi >> 24        ];
+    }
+#endif
+    return Oem7CRC32Bytewise(data, len, crc);
+  }
+
+
+#ifdef OEM7_CRC32_PCLMUL
+
+  bool isOem7CRC32PCLMULSupported()
+  {
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+      return false;
+    }
+
+    return (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+  }
+
+  /*
+   * Folding by 4x128 bits, then 128 bits; Barrett reduction to 32 bits. Refer to Intel: "Fast CRC Computation for
+   * Generic Polynomials Using PCLMULQDQ Instruction"; constants are for the bit-reflected polynomial 0xEDB88320.
+   */
+  __attribute__((target("pclmul,sse4.1")))
+  uint32_t Oem7CRC32PCLMUL(const uint8_t* data, size_t len, uint32_t crc)
+  {
+    if(len < 64)
+    {
+      return Oem7CRC32Slice8(data, len, crc);
+    }
+
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4); // x^(4*128+32), x^(4*128-32) mod P
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0); // x^(128+32),   x^(128-32)   mod P
+    const __m128i k5   = _mm_set_epi64x(0,            0x0163cd6124); // x^64 mod P
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641); // Barrett: mu, P
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+    data += 64;
+    len  -= 64;
+
+    // 4 x 128 bits in parallel.
+    for(; len >= 64; data += 64, len -= 64)
+    {
+      const __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+      const __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+      const __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+      const __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+      x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+      x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+      x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+      x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+      x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+      x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)));
+      x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)));
+    }
+
+    // Fold into 128 bits.
+    const __m128i rest[3] = {x2, x3, x4};
+    for(int i = 0; i < 3; i++)
+    {
+      const __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), rest[i]);
+    }
+
+    for(; len >= 16; data += 16, len -= 16)
+    {
+      const __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    }
+
+    // Fold 128 bits to 64 bits.
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x5);
+
+    x5 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5, 0x00);
+    x1 = _mm_xor_si128(x1, x5);
+
+    // Barrett reduction to 32 bits.
+    x5 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+    x5 = _mm_clmulepi64_si128(_mm_and_si128(x5, mask32), poly, 0x00);
+    x1 = _mm_xor_si128(x1, x5);
+
+    return Oem7CRC32Slice8(data, len, _mm_extract_epi32(x1, 1));
+  }
+
+#else
+
+  bool isOem7CRC32PCLMULSupported()
+  {
+    return false;
+  }
+
+  uint32_t Oem7CRC32PCLMUL(const uint8_t* data, size_t len, uint32_t crc)
+  {
+    return Oem7CRC32Slice8(data, len, crc);
+  }
+
+#endif
+}
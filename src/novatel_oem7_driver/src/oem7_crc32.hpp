@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_CRC32_HPP__
+#define __OEM7_CRC32_HPP__
+
+#include <stdint.h>
+#include <cstddef>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Oem7 CRC-32: reflected polynomial 0xEDB88320, initial value 0, no final XOR; as used to validate Oem7 binary
+   * messages. The CRC of a message followed by its CRC is 0.
+   *
+   * All functions return the CRC of the data, continuing from crc; 0 for a new CRC.
+   */
+
+  /**
+   * Fastest implementation supported by the CPU, selected at runtime.
+   */
+  uint32_t Oem7CRC32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+  /**
+   * @return name of the implementation used by Oem7CRC32.
+   */
+  const char* getOem7CRC32Name();
+
+  /**
+   * One byte at a time. Reference implementation.
+   */
+  uint32_t Oem7CRC32Bytewise(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+  /**
+   * 8 bytes at a time, using 8 lookup tables.
+   */
+  uint32_t Oem7CRC32Slice8(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+  /**
+   * @return true if the CPU supports Oem7CRC32PCLMUL.
+   */
+  bool isOem7CRC32PCLMULSupported();
+
+  /**
+   * 64 bytes at a time, folding with carry-less multiplication (x86 PCLMULQDQ); shorter data, and the tail, using
+   * Oem7CRC32Slice8. Only when isOem7CRC32PCLMULSupported().
+   */
+  uint32_t Oem7CRC32PCLMUL(const uint8_t* data, size_t len, uint32_t crc = 0);
+}
+
+#endif
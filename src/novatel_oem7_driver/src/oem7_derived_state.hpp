@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_DERIVED_STATE_HPP__
+#define __OEM7_DERIVED_STATE_HPP__
+
+#include "geometry_msgs/Quaternion.h"
+
+#include <cmath>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Orientation of an INS attitude, in both frames published by the driver.
+   */
+  struct Oem7Orientation
+  {
+    geometry_msgs::Quaternion enu; ///< INSPVA 'y-forward' ENU orientation; Imu.
+    geometry_msgs::Quaternion ros; ///< ROS x-forward orientation, i.e. enu rotated 90 deg about Z; Odometry.
+  };
+
+  /**
+   * Converts INSPVA attitude to orientation in both frames.
+   *
+   * Fused equivalent of tf2::Quaternion::setRPY(roll, -pitch, -azimuth), followed by a 90 deg rotation about Z:
+   * one set of half-angle sin/cos serves both quaternions, and the rotation is applied in closed form.
+   */
+  inline void INSAttitudeToOrientation(
+      double roll_deg,    ///< [in] INSPVA roll
+      double pitch_deg,   ///< [in] INSPVA pitch
+      double azimuth_deg, ///< [in] INSPVA azimuth
+      Oem7Orientation& orientation ///< [out]
+      )
+  {
+    static const double HALF_DEG_TO_RAD = M_PI / 360.0;
+    static const double SIN_45 = M_SQRT1_2; // Z90 = (0, 0, sin 45, cos 45)
+
+    const double half_roll  =  roll_deg    * HALF_DEG_TO_RAD;
+    const double half_pitch = -pitch_deg   * HALF_DEG_TO_RAD;
+    const double half_yaw   = -azimuth_deg * HALF_DEG_TO_RAD;
+
+    const double sr = std::sin(half_roll),  cr = std::cos(half_roll);
+    const double sp = std::sin(half_pitch), cp = std::cos(half_pitch);
+    const double sy = std::sin(half_yaw),   cy = std::cos(half_yaw);
+
+    geometry_msgs::Quaternion& enu = orientation.enu;
+    enu.x = sr * cp * cy - cr * sp * sy;
+    enu.y = cr * sp * cy + sr * cp * sy;
+    enu.z = cr * cp * sy - sr * sp * cy;
+    enu.w = cr * cp * cy + sr * sp * sy;
+
+    geometry_msgs::Quaternion& ros = orientation.ros;
+    ros.x = SIN_45 * (enu.x - enu.y);
+    ros.y = SIN_45 * (enu.y + enu.x);
+    ros.z = SIN_45 * (enu.z + enu.w);
+    ros.w = SIN_45 * (enu.w - enu.z);
+  }
+
+
+  /**
+   * Quantities derived from the latest INS solution, shared by the handlers processing it.
+   *
+   * Each quantity is recomputed only when its inputs change: INSPVA orientation is computed once for both Imu and
+   * Odometry, rather than for every message derived from it.
+   * Thread-local: handlers of a message run on the same thread, and need no locking.
+   * Positions are projected by Oem7LocalProjection, which depends on handler configuration.
+   */
+  class Oem7DerivedStateCache
+  {
+    double          roll_;
+    double          pitch_;
+    double          azimuth_;
+    Oem7Orientation orientation_;
+
+    Oem7DerivedStateCache():
+      roll_(NAN),
+      pitch_(NAN),
+      azimuth_(NAN)
+    {
+    }
+
+  public:
+    static Oem7DerivedStateCache& instance()
+    {
+      static thread_local Oem7DerivedStateCache cache;
+      return cache;
+    }
+
+    /**
+     * @return orientation of INS attitude
+     */
+    const Oem7Orientation& getOrientation(double roll, double pitch, double azimuth)
+    {
+      if(roll != roll_ || pitch != pitch_ || azimuth != azimuth_)
+      {
+        INSAttitudeToOrientation(roll, pitch, azimuth, orientation_);
+
+        roll_    = roll;
+        pitch_   = pitch;
+        azimuth_ = azimuth;
+      }
+
+      return orientation_;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_DISPATCH_TABLE_HPP__
+#define __OEM7_DISPATCH_TABLE_HPP__
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdint.h>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Flat dispatch table, mapping Oem7 message IDs to the handlers registered for them.
+ *
+ * Oem7 message IDs are dense 16-bit values, so the table is a plain array indexed by ID, sized to the largest
+ * registered ID. Each entry is a span into a single contiguous array of handlers; lookup is O(1) and
+ * touches two cache lines.
+ *
+ * Handlers are registered with add(), then build() is called once; the table is immutable afterwards.
+ */
+template <typename H>
+class Oem7DispatchTable
+{
+public:
+  struct Span
+  {
+    const H* begin_;
+    const H* end_;
+
+    const H* begin() const { return begin_; }
+    const H* end()   const { return end_;   }
+    bool     empty() const { return begin_ == end_; }
+  };
+
+private:
+  struct Range
+  {
+    uint32_t offset; ///< Index of the first handler in handlers_
+    uint32_t count;  ///< Number of handlers
+  };
+
+  std::vector<std::pair<uint16_t, H> > pending_; ///< Registrations before build(), in registration order.
+  std::vector<H>     handlers_; ///< Handlers, grouped by message ID.
+  std::vector<Range> ranges_;   ///< Indexed by message ID.
+
+public:
+  /**
+   * Registers a handler for a message ID. Handlers of the same ID are dispatched in registration order.
+   */
+  void add(uint16_t msg_id, const H& handler)
+  {
+    pending_.push_back(std::make_pair(msg_id, handler));
+  }
+
+  /**
+   * Lays out the table from registered handlers.
+   */
+  void build()
+  {
+    // Stable: handlers of the same message ID retain the order of registration.
+    std::stable_sort(pending_.begin(), pending_.end(),
+        [](const std::pair<uint16_t, H>& l, const std::pair<uint16_t, H>& r){ return l.first < r.first; });
+
+    handlers_.clear();
+    ranges_.clear();
+
+    if(!pending_.empty())
+    {
+      ranges_.resize(pending_.back().first + 1u, Range{0, 0});
+    }
+
+    handlers_.reserve(pending_.size());
+    for(size_t i = 0; i < pending_.size(); i++)
+    {
+      Range& range = ranges_[pending_[i].first];
+      if(range.count == 0)
+      {
+        range.offset = handlers_.size();
+      }
+      range.count++;
+      handlers_.push_back(pending_[i].second);
+    }
+
+    pending_.clear();
+  }
+
+  /**
+   * @return handlers registered for the message ID; empty if there are none.
+   */
+  Span lookup(unsigned int msg_id) const
+  {
+    if(msg_id >= ranges_.size())
+    {
+      return Span{NULL, NULL};
+    }
+
+    const Range& range = ranges_[msg_id];
+    const H* begin = handlers_.data() + range.offset;
+    return Span{begin, begin + range.count};
+  }
+
+  size_t size() const
+  {
+    return handlers_.size();
+  }
+};
+
+}
+#endif
@@ -22,6 +22,9 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#ifndef __OEM7_DRIVER_UTIL_HPP__
+#define __OEM7_DRIVER_UTIL_HPP__
+
 #include <stdint.h>
 #include "novatel_oem7_msgs/Oem7Header.h"
 
@@ -46,3 +49,5 @@ namespace novatel_oem7_driver
     return GPSTimeToMsec(hdr.gps_week_number, hdr.gps_week_milliseconds);
   }
 }
+
+#endif
@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_HEADER_STAMPER_HPP__
+#define __OEM7_HEADER_STAMPER_HPP__
+
+#include <ros/ros.h>
+
+#include <novatel_oem7_driver/oem7_message_util.hpp>
+#include <oem7_driver_util.hpp>
+#include <oem7_time_offset_estimator.hpp>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Derives ROS header stamps from the GPS time in Oem7 message headers, rather than from message arrival.
+ *
+ * Modes:
+ *  arrival:  arrival time of the message on the host; the default.
+ *  gps:      GPS time of the message, as UTC; for hosts synchronized to the receiver, e.g. by PPS or PTP.
+ *  gps_host: GPS time of the message, mapped to host time by an offset and drift estimate fed by TIME log arrivals.
+ *            Free of the jitter added by host load and driver queueing.
+ *
+ * Messages without GPS time (ASCII, NMEA, or before the receiver knows the time) keep their arrival stamp;
+ * so do all messages in gps_host mode, until the first TIME log with a valid clock.
+ */
+class Oem7HeaderStamper
+{
+public:
+  enum Mode
+  {
+    STAMP_ARRIVAL,
+    STAMP_GPS,
+    STAMP_GPS_HOST
+  };
+
+private:
+  static const int64_t GPS_EPOCH_UNIX_SEC = 315964800; ///< 1980-01-06, Unix time.
+
+  static const uint32_t CLOCK_STATUS_VALID = 0; ///< TIME clock_status
+  static const uint32_t UTC_STATUS_VALID   = 1; ///< TIME utc_status
+
+  Mode   mode_;
+  double utc_offset_; ///< UTC - GPS time, seconds; updated from TIME logs.
+
+  Oem7TimeOffsetEstimator estimator_; ///< GPS time --> host time
+
+  /**
+   * Updates UTC offset and host time estimate from a TIME log.
+   */
+  void onTime(
+      const Oem7RawMessageIf::ConstPtr& raw_msg,
+      double gps_t,
+      const ros::Time& arrival)
+  {
+    if(raw_msg->getMessageFormat() != Oem7RawMessageIf::OEM7MSGFMT_BINARY ||
+       raw_msg->getMessageDataLength() < OEM7_BINARY_MSG_HDR_LEN + sizeof(TIMEMem))
+    {
+      return;
+    }
+
+    const TIMEMem* time = reinterpret_cast<const TIMEMem*>(raw_msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
+    if(time->utc_status == UTC_STATUS_VALID)
+    {
+      utc_offset_ = time->utc_offset;
+    }
+
+    if(time->clock_status == CLOCK_STATUS_VALID && !arrival.isZero())
+    {
+      estimator_.addSample(gps_t, arrival.toSec());
+    }
+  }
+
+public:
+  Oem7HeaderStamper():
+    mode_(STAMP_ARRIVAL),
+    utc_offset_(-18.0)
+  {
+  }
+
+  /**
+   * Configures stamping.
+   *
+   * @return false if the mode is not known.
+   */
+  bool initialize(
+      const std::string& mode, ///< arrival, gps, gps_host; see above.
+      double window_sec        ///< gps_host: offset estimation window
+      )
+  {
+    if(mode == "arrival")
+    {
+      mode_ = STAMP_ARRIVAL;
+    }
+    else if(mode == "gps")
+    {
+      mode_ = STAMP_GPS;
+    }
+    else if(mode == "gps_host")
+    {
+      mode_ = STAMP_GPS_HOST;
+    }
+    else
+    {
+      return false;
+    }
+
+    estimator_ = Oem7TimeOffsetEstimator(window_sec);
+    return true;
+  }
+
+  Mode getMode() const
+  {
+    return mode_;
+  }
+
+  /**
+   * Replaces the arrival stamp of a message with one derived from its GPS time, according to the mode.
+   */
+  void stamp(
+      const Oem7RawMessageIf::ConstPtr& raw_msg, ///< [in] Message
+      ros::Time& stamp                           ///< [in,out] Arrival time; replaced if GPS time is available
+      )
+  {
+    if(mode_ == STAMP_ARRIVAL)
+    {
+      return;
+    }
+
+    uint16_t gps_week;
+    uint32_t gps_msec;
+    if(!getOem7MessageGPSTime(raw_msg, gps_week, gps_msec) || gps_week == 0) // Week 0: time not yet known to receiver.
+    {
+      return;
+    }
+
+    const double gps_t = GPSTimeToMsec(gps_week, gps_msec) / 1000.0;
+
+    if(raw_msg->getMessageId() == TIME_OEM7_MSGID)
+    {
+      onTime(raw_msg, gps_t, stamp);
+    }
+
+    if(mode_ == STAMP_GPS)
+    {
+      stamp.fromSec(GPS_EPOCH_UNIX_SEC + gps_t + utc_offset_);
+    }
+    else if(estimator_.isValid())
+    {
+      stamp.fromSec(estimator_.toHostTime(gps_t));
+    }
+  }
+};
+
+}
+#endif
@@ -0,0 +1,301 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_LATENCY_HPP__
+#define __OEM7_LATENCY_HPP__
+
+/*! \file
+ * Hot path latency instrumentation; enabled when built with OEM7_LATENCY_INSTRUMENTATION defined
+ * (cmake -DOEM7_LATENCY_INSTRUMENTATION=ON).
+ *
+ * Each message is timestamped as it passes through the driver's stages:
+ *  read:      receiver input containing the message is returned to the decoder
+ *  decode:    decoder emits the message
+ *  handler:   message handling starts
+ *  convert:   ROS message is generated; publishing starts
+ *  publish:   ROS message is published
+ *
+ * The read time is passed by the decoder with each message; the trace is started when the message is decoded,
+ * kept thread-local while it is handled, and carried across pipeline queues.
+ * When instrumentation is disabled, the OEM7_LATENCY_* macros expand to nothing.
+ */
+
+#ifdef OEM7_LATENCY_INSTRUMENTATION
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+
+namespace novatel_oem7_driver
+{
+  inline int64_t Oem7LatencyNow()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /**
+   * Stage timestamps of the message being processed, ns.
+   */
+  struct Oem7LatencyTrace
+  {
+    int64_t read_ns;
+    int64_t decode_ns;
+    int64_t handler_ns;
+    int     msg_id;
+
+    Oem7LatencyTrace():
+      read_ns(0),
+      decode_ns(0),
+      handler_ns(0),
+      msg_id(-1)
+    {
+    }
+  };
+
+  /**
+   * Per-thread tracing state.
+   */
+  struct Oem7LatencyContext
+  {
+    Oem7LatencyTrace trace; ///< Message currently processed on this thread
+
+    static Oem7LatencyContext& current()
+    {
+      static thread_local Oem7LatencyContext ctx;
+      return ctx;
+    }
+  };
+
+
+  /**
+   * Latency histogram with log-linear buckets: 8 buckets per power of 2, i.e. within 12.5%.
+   */
+  class Oem7LatencyHistogram
+  {
+    enum
+    {
+      SUB_BITS    = 3,
+      NUM_LINEAR  = 1 << (SUB_BITS + 1), ///< Values below are counted exactly.
+      MAX_MSB     = 40,                  ///< ~18 minutes; larger values go to the last bucket.
+      NUM_BUCKETS = NUM_LINEAR + (MAX_MSB - SUB_BITS) * (1 << SUB_BITS)
+    };
+
+    std::vector<uint32_t> buckets_;
+    uint64_t count_;
+    int64_t  max_;
+
+    static size_t bucketOf(int64_t ns)
+    {
+      if(ns < NUM_LINEAR)
+      {
+        return ns < 0 ? 0 : ns;
+      }
+
+      const int msb = 63 - __builtin_clzll(ns);
+      if(msb >= MAX_MSB)
+      {
+        return NUM_BUCKETS - 1;
+      }
+
+      const size_t sub = (ns >> (msb - SUB_BITS)) & ((1 << SUB_BITS) - 1);
+      return NUM_LINEAR + (msb - SUB_BITS - 1) * (1 << SUB_BITS) + sub;
+    }
+
+    static int64_t upperBoundOf(size_t bucket)
+    {
+      if(bucket < NUM_LINEAR)
+      {
+        return bucket;
+      }
+
+      const size_t msb = (bucket - NUM_LINEAR) / (1 << SUB_BITS) + SUB_BITS + 1;
+      const size_t sub = (bucket - NUM_LINEAR) % (1 << SUB_BITS);
+      return ((int64_t(1) << SUB_BITS | sub) + 1) << (msb - SUB_BITS);
+    }
+
+  public:
+    Oem7LatencyHistogram():
+      buckets_(NUM_BUCKETS, 0),
+      count_(0),
+      max_(0)
+    {
+    }
+
+    void add(int64_t ns)
+    {
+      buckets_[bucketOf(ns)]++;
+      count_++;
+      max_ = std::max(max_, ns);
+    }
+
+    uint64_t count() const
+    {
+      return count_;
+    }
+
+    int64_t max() const
+    {
+      return max_;
+    }
+
+    /**
+     * @return value at or below which 'p' of the samples fall, within bucket resolution; ns.
+     */
+    int64_t percentile(double p) const
+    {
+      const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * count_ + 0.5));
+      uint64_t cumulative = 0;
+      for(size_t b = 0; b < buckets_.size(); b++)
+      {
+        cumulative += buckets_[b];
+        if(cumulative >= rank)
+        {
+          return std::min(upperBoundOf(b), max_);
+        }
+      }
+      return max_;
+    }
+  };
+
+
+  /**
+   * Collects latency histograms per Oem7 message ID.
+   */
+  class Oem7LatencyRecorder
+  {
+  public:
+    enum Interval
+    {
+      READ_TO_DECODE,
+      DECODE_TO_HANDLER,
+      HANDLER_TO_CONVERT,
+      CONVERT_TO_PUBLISH,
+      READ_TO_PUBLISH,
+      NUM_INTERVALS
+    };
+
+    struct MessageLatency
+    {
+      Oem7LatencyHistogram interval[NUM_INTERVALS];
+    };
+
+    typedef std::map<int, MessageLatency> LatencyMap;
+
+    static const char* getIntervalName(int interval)
+    {
+      static const char* NAMES[NUM_INTERVALS] = {"decode", "queue", "convert", "publish", "total"};
+      return NAMES[interval];
+    }
+
+    static Oem7LatencyRecorder& instance()
+    {
+      static Oem7LatencyRecorder recorder;
+      return recorder;
+    }
+
+    /**
+     * Records a published message.
+     */
+    void record(const Oem7LatencyTrace& trace, int64_t convert_ns, int64_t publish_ns)
+    {
+      if(trace.handler_ns == 0) // Not published while handling a message.
+        return;
+
+      std::lock_guard<std::mutex> lk(mtx_);
+      MessageLatency& latency = latency_[trace.msg_id];
+      if(trace.read_ns != 0)
+      {
+        latency.interval[READ_TO_DECODE].add( trace.decode_ns - trace.read_ns);
+        latency.interval[READ_TO_PUBLISH].add(publish_ns      - trace.read_ns);
+      }
+      latency.interval[DECODE_TO_HANDLER ].add(trace.handler_ns - trace.decode_ns);
+      latency.interval[HANDLER_TO_CONVERT].add(convert_ns       - trace.handler_ns);
+      latency.interval[CONVERT_TO_PUBLISH].add(publish_ns       - convert_ns);
+    }
+
+    /**
+     * Obtains the histograms collected since the previous call, and starts a new window.
+     */
+    void takeWindow(LatencyMap& window)
+    {
+      window.clear();
+      std::lock_guard<std::mutex> lk(mtx_);
+      window.swap(latency_);
+    }
+
+  private:
+    std::mutex mtx_;
+    LatencyMap latency_;
+  };
+}
+
+/// Current time, ns; 0 when instrumentation is disabled.
+#define OEM7_LATENCY_NOW() novatel_oem7_driver::Oem7LatencyNow()
+
+/// Message emitted by the decoder, completed by input read at 'read_ns'; starts its trace.
+#define OEM7_LATENCY_DECODE(id, read_ns) \
+  do { \
+    novatel_oem7_driver::Oem7LatencyContext& ctx_ = novatel_oem7_driver::Oem7LatencyContext::current(); \
+    ctx_.trace.read_ns    = (read_ns); \
+    ctx_.trace.decode_ns  = novatel_oem7_driver::Oem7LatencyNow(); \
+    ctx_.trace.handler_ns = 0; \
+    ctx_.trace.msg_id     = (id); \
+  } while(0)
+
+/// Message handling started.
+#define OEM7_LATENCY_HANDLER() \
+  (novatel_oem7_driver::Oem7LatencyContext::current().trace.handler_ns = novatel_oem7_driver::Oem7LatencyNow())
+
+/// Declares a trace member, for carrying the trace with a queued message.
+#define OEM7_LATENCY_TRACE_FIELD(name) novatel_oem7_driver::Oem7LatencyTrace name;
+#define OEM7_LATENCY_SAVE(dst)      ((dst) = novatel_oem7_driver::Oem7LatencyContext::current().trace)
+#define OEM7_LATENCY_RESTORE(src)   (novatel_oem7_driver::Oem7LatencyContext::current().trace = (src))
+
+/// ROS message generated; publishing starts.
+#define OEM7_LATENCY_CONVERTED(var) const int64_t var = novatel_oem7_driver::Oem7LatencyNow()
+
+/// ROS message published.
+#define OEM7_LATENCY_PUBLISHED(var) \
+  novatel_oem7_driver::Oem7LatencyRecorder::instance().record( \
+        novatel_oem7_driver::Oem7LatencyContext::current().trace, var, novatel_oem7_driver::Oem7LatencyNow())
+
+#else
+
+#define OEM7_LATENCY_NOW() 0
+#define OEM7_LATENCY_DECODE(id, read_ns)
+#define OEM7_LATENCY_HANDLER()
+#define OEM7_LATENCY_TRACE_FIELD(name)
+#define OEM7_LATENCY_SAVE(dst)
+#define OEM7_LATENCY_RESTORE(src)
+#define OEM7_LATENCY_CONVERTED(var)
+#define OEM7_LATENCY_PUBLISHED(var)
+
+#endif
+
+#endif
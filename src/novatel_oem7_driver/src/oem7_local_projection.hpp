@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_LOCAL_PROJECTION_HPP__
+#define __OEM7_LOCAL_PROJECTION_HPP__
+
+#include "geometry_msgs/Point.h"
+
+#include <cmath>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Projects GNSS positions to Odometry coordinates.
+ *
+ * Modes:
+ *  UTM: x: northing, y: easting, z: height; zero origin. The projection follows gps_common::LLtoUTM; the zone is cached,
+ *       and only looked up again when the position leaves the area where it applies.
+ *  ENU: x: east, y: north, z: up, meters from an origin: configured, or else the first position projected.
+ *       Free of UTM zone boundary jumps. The ECEF rotation coefficients of the origin are cached, so that after
+ *       the geodetic to ECEF conversion of the position, each update is a handful of multiply-adds.
+ */
+class Oem7LocalProjection
+{
+public:
+  enum Mode
+  {
+    PROJECTION_UTM,
+    PROJECTION_ENU
+  };
+
+private:
+  static constexpr double WGS84_A  = 6378137.0;
+  static constexpr double WGS84_F  = 1.0 / 298.257223563;
+  static constexpr double WGS84_E2 = WGS84_F * (2.0 - WGS84_F);
+
+  static constexpr double UTM_K0 = 0.9996;
+  static constexpr double UTM_FE = 500000.0;    ///< False easting
+  static constexpr double UTM_FN_S = 10000000.0; ///< False northing, southern hemisphere
+
+  static constexpr double DEG_TO_RAD = M_PI / 180.0;
+
+  Mode mode_;
+
+  // ENU
+  bool   has_origin_;
+  double origin_x_; ///< ECEF
+  double origin_y_;
+  double origin_z_;
+  double r_[3][3];  ///< ECEF --> ENU rotation at origin
+
+  // UTM zone cache: zone_ applies to positions within [lat_lo_, lat_hi_) x [lon_lo_, lon_hi_).
+  int    zone_;
+  double lat_lo_, lat_hi_;
+  double lon_lo_, lon_hi_;
+  double lon_origin_rad_; ///< Central meridian of zone_
+
+  // Last position projected
+  double lat_;
+  double lon_;
+  double hgt_;
+  geometry_msgs::Point pt_;
+
+
+  static void toECEF(double lat, double lon, double hgt, double& x, double& y, double& z)
+  {
+    const double sin_lat = std::sin(lat * DEG_TO_RAD), cos_lat = std::cos(lat * DEG_TO_RAD);
+    const double sin_lon = std::sin(lon * DEG_TO_RAD), cos_lon = std::cos(lon * DEG_TO_RAD);
+
+    const double n = WGS84_A / std::sqrt(1.0 - WGS84_E2 * sin_lat * sin_lat); // Prime vertical radius
+
+    x = (n + hgt) * cos_lat * cos_lon;
+    y = (n + hgt) * cos_lat * sin_lon;
+    z = (n * (1.0 - WGS84_E2) + hgt) * sin_lat;
+  }
+
+  void projectENU(double lat, double lon, double hgt, geometry_msgs::Point& pt) const
+  {
+    double x, y, z;
+    toECEF(lat, lon, hgt, x, y, z);
+
+    const double dx = x - origin_x_;
+    const double dy = y - origin_y_;
+    const double dz = z - origin_z_;
+
+    pt.x = r_[0][0] * dx + r_[0][1] * dy + r_[0][2] * dz;
+    pt.y = r_[1][0] * dx + r_[1][1] * dy + r_[1][2] * dz;
+    pt.z = r_[2][0] * dx + r_[2][1] * dy + r_[2][2] * dz;
+  }
+
+  /**
+   * Looks up the UTM zone of a position, including the Norway and Svalbard exceptions,
+   * and the area within which the zone applies.
+   */
+  void lookupUTMZone(double lat, double lon)
+  {
+    static const double LAT_BANDS[] = {-HUGE_VAL, 0.0, 56.0, 64.0, 72.0, 84.0, HUGE_VAL};
+
+    size_t band = 0;
+    while(lat >= LAT_BANDS[band + 1])
+    {
+      band++;
+    }
+    lat_lo_ = LAT_BANDS[band];
+    lat_hi_ = LAT_BANDS[band + 1];
+
+    zone_   = static_cast<int>(std::floor((lon + 180.0) / 6.0)) + 1;
+    lon_lo_ = (zone_ - 1) * 6.0 - 180.0;
+    lon_hi_ = lon_lo_ + 6.0;
+
+    if(lat_lo_ == 56.0) // Southern Norway
+    {
+      if(lon >= 3.0 && lon < 12.0)
+      {
+        zone_ = 32; lon_lo_ = 3.0; lon_hi_ = 12.0;
+      }
+      else if(zone_ == 31)
+      {
+        lon_hi_ = 3.0;
+      }
+    }
+    else if(lat_lo_ == 72.0 && lon >= 0.0 && lon < 42.0) // Svalbard
+    {
+      if(     lon <  9.0) { zone_ = 31; lon_lo_ =  0.0; lon_hi_ =  9.0; }
+      else if(lon < 21.0) { zone_ = 33; lon_lo_ =  9.0; lon_hi_ = 21.0; }
+      else if(lon < 33.0) { zone_ = 35; lon_lo_ = 21.0; lon_hi_ = 33.0; }
+      else                { zone_ = 37; lon_lo_ = 33.0; lon_hi_ = 42.0; }
+    }
+
+    lon_origin_rad_ = ((zone_ - 1) * 6.0 - 180.0 + 3.0) * DEG_TO_RAD;
+  }
+
+  void projectUTM(double lat, double lon, double hgt, geometry_msgs::Point& pt)
+  {
+    lon = lon - std::floor((lon + 180.0) / 360.0) * 360.0; // [-180, 180)
+
+    if(lat < lat_lo_ || lat >= lat_hi_ || lon < lon_lo_ || lon >= lon_hi_)
+    {
+      lookupUTMZone(lat, lon);
+    }
+
+    static const double E2  = WGS84_E2;
+    static const double EP2 = E2 / (1.0 - E2);
+
+    const double lat_rad = lat * DEG_TO_RAD;
+    const double sin_lat = std::sin(lat_rad);
+    const double cos_lat = std::cos(lat_rad);
+    const double tan_lat = sin_lat / cos_lat;
+
+    const double n = WGS84_A / std::sqrt(1.0 - E2 * sin_lat * sin_lat);
+    const double t = tan_lat * tan_lat;
+    const double c = EP2 * cos_lat * cos_lat;
+    const double a = cos_lat * (lon * DEG_TO_RAD - lon_origin_rad_);
+
+    const double m = WGS84_A * ((1.0 - E2 / 4.0 - 3.0 * E2 * E2 / 64.0 - 5.0 * E2 * E2 * E2 / 256.0) * lat_rad
+                             - (3.0 * E2 / 8.0 + 3.0 * E2 * E2 / 32.0 + 45.0 * E2 * E2 * E2 / 1024.0) * std::sin(2.0 * lat_rad)
+                             + (15.0 * E2 * E2 / 256.0 + 45.0 * E2 * E2 * E2 / 1024.0) * std::sin(4.0 * lat_rad)
+                             - (35.0 * E2 * E2 * E2 / 3072.0) * std::sin(6.0 * lat_rad));
+
+    const double a2 = a * a;
+    const double a3 = a2 * a;
+    const double a4 = a3 * a;
+
+    const double easting = UTM_K0 * n * (a + (1.0 - t + c) * a3 / 6.0
+                                       + (5.0 - 18.0 * t + t * t + 72.0 * c - 58.0 * EP2) * a4 * a / 120.0)
+                           + UTM_FE;
+
+    double northing = UTM_K0 * (m + n * tan_lat * (a2 / 2.0 + (5.0 - t + 9.0 * c + 4.0 * c * c) * a4 / 24.0
+                                      + (61.0 - 58.0 * t + t * t + 600.0 * c - 330.0 * EP2) * a4 * a2 / 720.0));
+    if(lat < 0.0)
+    {
+      northing += UTM_FN_S;
+    }
+
+    pt.x = northing;
+    pt.y = easting;
+    pt.z = hgt;
+  }
+
+public:
+  Oem7LocalProjection():
+    mode_(PROJECTION_UTM),
+    has_origin_(false),
+    origin_x_(0.0),
+    origin_y_(0.0),
+    origin_z_(0.0),
+    zone_(0),
+    lat_lo_(0.0),
+    lat_hi_(0.0),
+    lon_lo_(0.0),
+    lon_hi_(0.0),
+    lon_origin_rad_(0.0),
+    lat_(NAN),
+    lon_(NAN),
+    hgt_(NAN)
+  {
+  }
+
+  void setMode(Mode mode)
+  {
+    mode_ = mode;
+    lat_  = NAN; // Invalidate last position
+  }
+
+  Mode getMode() const
+  {
+    return mode_;
+  }
+
+  /**
+   * Sets ENU origin, and caches its ECEF rotation coefficients.
+   */
+  void setOrigin(double lat, double lon, double hgt)
+  {
+    toECEF(lat, lon, hgt, origin_x_, origin_y_, origin_z_);
+
+    const double sin_lat = std::sin(lat * DEG_TO_RAD), cos_lat = std::cos(lat * DEG_TO_RAD);
+    const double sin_lon = std::sin(lon * DEG_TO_RAD), cos_lon = std::cos(lon * DEG_TO_RAD);
+
+    r_[0][0] = -sin_lon;           r_[0][1] =  cos_lon;           r_[0][2] = 0.0;
+    r_[1][0] = -sin_lat * cos_lon; r_[1][1] = -sin_lat * sin_lon; r_[1][2] = cos_lat;
+    r_[2][0] =  cos_lat * cos_lon; r_[2][1] =  cos_lat * sin_lon; r_[2][2] = sin_lat;
+
+    has_origin_ = true;
+    lat_        = NAN;
+  }
+
+  /**
+   * @return true if the ENU origin is set.
+   */
+  bool hasOrigin() const
+  {
+    return has_origin_;
+  }
+
+  /**
+   * Projects a position; repeated positions are not projected again.
+   */
+  void project(
+      double lat, ///< [in] degrees
+      double lon, ///< [in] degrees
+      double hgt, ///< [in] meters
+      geometry_msgs::Point& pt ///< [out]
+      )
+  {
+    if(lat != lat_ || lon != lon_ || hgt != hgt_)
+    {
+      if(mode_ == PROJECTION_ENU)
+      {
+        if(!has_origin_)
+        {
+          setOrigin(lat, lon, hgt);
+        }
+        projectENU(lat, lon, hgt, pt_);
+      }
+      else
+      {
+        projectUTM(lat, lon, hgt, pt_);
+      }
+
+      lat_ = lat;
+      lon_ = lon;
+      hgt_ = hgt;
+    }
+
+    pt = pt_;
+  }
+};
+
+}
+#endif
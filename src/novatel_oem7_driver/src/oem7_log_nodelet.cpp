@@ -29,54 +29,167 @@
 
 #include "novatel_oem7_msgs/Oem7RawMsg.h"
 #include "novatel_oem7_driver/oem7_messages.h"
+#include "novatel_oem7_driver/oem7_message_util.hpp"
+#include <novatel_oem7_driver/oem7_raw_msg_shared.hpp>
+#include <oem7_param_cache.hpp>
+#include <oem7_message_context.hpp>
 
 #include <boost/scoped_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/pool/pool_alloc.hpp>
+
+#include <algorithm>
+#include <map>
 
 namespace novatel_oem7_driver
 {
 
   /*
-   * Adapter: novatel_oem7_msgs::Oem7RawMsg and Oem7RawMsgIf
+   * Adapter: Oem7RawMsg and Oem7RawMessageIf.
+   *
+   * References the message data in place; the header is parsed once, on construction.
    */
   class RawMsgAdapter: public Oem7RawMessageIf
   {
-  public:
-    const novatel_oem7_msgs::Oem7RawMsg::ConstPtr msg_;
+    const boost::shared_ptr<const uint8_t> data_; ///< Message data; keeps the ROS message alive.
+    const size_t data_len_;
+
+    Oem7MessageType   type_;
+    Oem7MessageFormat format_;
+    int               id_;
+
+    /**
+     * Obtains message ID from NMEA0183 sentence address, e.g. "$GPGGA,..."
+     */
+    static int getNMEAMessageId(const std::string& address)
+    {
+      static const std::map<std::string, int> NMEA_IDS =
+      {
+        {"GLMLA", GLMLA_OEM7_MSGID},
+        {"GPALM", GPALM_OEM7_MSGID},
+        {"GPGGA", GPGGA_OEM7_MSGID},
+        {"GPGLL", GPGLL_OEM7_MSGID},
+        {"GPGRS", GPGRS_OEM7_MSGID},
+        {"GPGSA", GPGSA_OEM7_MSGID},
+        {"GPGST", GPGST_OEM7_MSGID},
+        {"GPGSV", GPGSV_OEM7_MSGID},
+        {"GPHDT", GPHDT_OEM7_MSGID},
+        {"GPRMB", GPRMB_OEM7_MSGID},
+        {"GPRMC", GPRMC_OEM7_MSGID},
+        {"GPVTG", GPVTG_OEM7_MSGID},
+        {"GPZDA", GPZDA_OEM7_MSGID}
+      };
+
+      std::map<std::string, int>::const_iterator itr = NMEA_IDS.find(address);
+      return itr == NMEA_IDS.end() ? UNKNOWN_MSGID : itr->second;
+    }
+
+    /**
+     * @return the name field of an ASCII message or NMEA sentence, following the leading sync character.
+     */
+    std::string getAsciiMessageName() const
+    {
+      const char* begin = reinterpret_cast<const char*>(data_.get()) + 1;
+      const char* end   = reinterpret_cast<const char*>(data_.get()) + data_len_;
+      return std::string(begin, std::find_if(begin, end, [](char c){ return c == ',' || c == ';' || c == '*'; }));
+    }
+
+    void parseHeader()
+    {
+      static const uint8_t OEM7_BINARY_SYNC1       = 0xAA;
+      static const uint8_t OEM7_BINARY_SYNC2       = 0x44;
+      static const uint8_t OEM7_BINARY_SYNC3       = 0x12;
+      static const uint8_t OEM7_SHORT_BINARY_SYNC3 = 0x13;
+      static const uint8_t OEM7_RESPONSE_BIT       = 0x80; ///< In 'message_type' header field.
+
+      const uint8_t* data = data_.get();
+
+      if(data_len_ >= OEM7_BINARY_MSG_SHORT_HDR_LEN &&
+         data[0] == OEM7_BINARY_SYNC1 &&
+         data[1] == OEM7_BINARY_SYNC2)
+      {
+        const Oem7MessageCommonHeaderMem* common_hdr =
+            reinterpret_cast<const Oem7MessageCommonHeaderMem*>(data);
+
+        if(data[2] == OEM7_BINARY_SYNC3 && data_len_ >= OEM7_BINARY_MSG_HDR_LEN)
+        {
+          const Oem7MessageHeaderMem* hdr = reinterpret_cast<const Oem7MessageHeaderMem*>(common_hdr);
+
+          format_ = OEM7MSGFMT_BINARY;
+          type_   = (hdr->message_type & OEM7_RESPONSE_BIT) ? OEM7MSGTYPE_RSP : OEM7MSGTYPE_LOG;
+          id_     = hdr->message_id;
+        }
+        else if(data[2] == OEM7_SHORT_BINARY_SYNC3)
+        {
+          format_ = OEM7MSGFMT_BINARY;
+          type_   = OEM7MSGTYPE_LOG;
+          id_     = common_hdr->message_id;
+        }
+      }
+      else if(data_len_ > 1 && (data[0] == '#' || data[0] == '%')) // ASCII / short ASCII log
+      {
+        std::string name = getAsciiMessageName();
+        if(!name.empty() && name.back() == 'A')
+        {
+          name.pop_back(); // Format suffix
+        }
+
+        format_ = OEM7MSGFMT_ASCII;
+        type_   = OEM7MSGTYPE_LOG;
+        id_     = getOem7MessageId(name);
+      }
+      else if(data_len_ > 1 && data[0] == '$') // NMEA0183
+      {
+        format_ = OEM7MSGFMT_ASCII;
+        type_   = OEM7MSGTYPE_LOG;
+        id_     = getNMEAMessageId(getAsciiMessageName());
+      }
+    }
 
-    RawMsgAdapter(const novatel_oem7_msgs::Oem7RawMsg::ConstPtr& msg):
-      msg_(msg)
+  public:
+    enum
+    {
+      UNKNOWN_MSGID = -1
+    };
+
+    RawMsgAdapter(const boost::shared_ptr<const uint8_t>& data, size_t data_len):
+      data_(data),
+      data_len_(data_len),
+      type_(OEM7MSGTYPE_UNKNOWN),
+      format_(OEM7MSGFMT_UNKNOWN),
+      id_(UNKNOWN_MSGID)
     {
+      parseHeader();
     }
 
     Oem7MessageType getMessageType() const
     {
-      assert(false);
-      return Oem7RawMessageIf::OEM7MSGTYPE_UNKNOWN;
+      return type_;
     }
 
     Oem7MessageFormat getMessageFormat() const
     {
-      assert(false);
-      return Oem7RawMessageIf::OEM7MSGFMT_UNKNOWN;
+      return format_;
     }
 
     int  getMessageId() const
     {
-      const Oem7MessageCommonHeaderMem* mem =
-          reinterpret_cast<const Oem7MessageCommonHeaderMem*>(getMessageData(0));
-      return mem->message_id;
+      return id_;
     }
 
     const uint8_t* getMessageData(size_t offset) const
     {
-      return const_cast<uint8_t*>(msg_->message_data.data()); // FIXME
+      assert(offset <= data_len_);
+      return data_.get() + offset;
     }
 
     size_t getMessageDataLength() const
     {
-      return msg_->message_data.size();
+      return data_len_;
     }
   };
+
+
   /*
    * Nodelet responsible for decoding raw Oem7 messages and generating specific ROS and novatel_oem7_msg messages.
    * Subscribes to "oem7_raw_msg", and loads plugins which advertise specific messages.
@@ -84,6 +197,8 @@ namespace novatel_oem7_driver
    */
   class Oem7LogNodelet : public nodelet::Nodelet
   {
+    boost::scoped_ptr<Oem7RuntimeParamSnapshot> runtime_params_; ///< Tables handlers consult at runtime; outlives them.
+
     boost::scoped_ptr<MessageHandler> msg_handler_;
 
     ros::Subscriber oem7_raw_msg_sub_;
@@ -98,17 +213,31 @@ namespace novatel_oem7_driver
     {
       ros::NodeHandle nh = getNodeHandle();
       ros::NodeHandle priv_nh = getPrivateNodeHandle();
+
+      runtime_params_.reset(new Oem7RuntimeParamSnapshot);
+
+      initializeOem7MessageUtil(nh);
+
       msg_handler_.reset(new MessageHandler(priv_nh));
 
+      // Subscribing as Oem7RawMsgShared: messages published in zero-copy mode by a nodelet in the same process
+      // are received without copying; others are deserialized, as Oem7RawMsg would be.
       oem7_raw_msg_sub_ = nh.subscribe("oem7_raw_msg", 100, &Oem7LogNodelet::oem7RawMsgCb, this);
     }
 
     /**
      * Dispatches raw messages for handling
      */
-    void oem7RawMsgCb(const novatel_oem7_msgs::Oem7RawMsg::ConstPtr& msg)
+    void oem7RawMsgCb(const Oem7RawMsgShared::ConstPtr& msg)
     {
-      boost::shared_ptr<RawMsgAdapter> raw_msg = boost::make_shared<RawMsgAdapter>(msg);
+      // Pool-allocated; handlers may retain the message.
+      Oem7RawMessageIf::ConstPtr raw_msg =
+          boost::allocate_shared<RawMsgAdapter>(boost::fast_pool_allocator<RawMsgAdapter>(),
+                                                msg->message_data,
+                                                msg->message_data_len);
+
+      // Messages derived from this one are stamped with its arrival, as in the single process configuration.
+      Oem7MessageScope scope(msg->header.stamp);
       msg_handler_->handleMessage(raw_msg);
     }
   };
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_LOG_STATISTICS_HPP__
+#define __OEM7_LOG_STATISTICS_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <stdint.h>
+
+#include <boost/scoped_array.hpp>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Per message ID log counters.
+ *
+ * Counters are a flat array indexed by message ID, updated without locks by a single writer (the decoder thread)
+ * and read concurrently by any number of readers, e.g. a diagnostics timer.
+ */
+class Oem7LogStatistics
+{
+public:
+  enum
+  {
+    NUM_MSG_IDS = 65536 ///< Oem7 message IDs are 16-bit.
+  };
+
+  /**
+   * Counters of a single message ID.
+   */
+  struct LogCounters
+  {
+    std::atomic<uint64_t> count;      ///< Messages received
+    std::atomic<uint64_t> bytes;      ///< Message bytes received
+    std::atomic<int64_t>  last_ns;    ///< Arrival of the latest message
+    std::atomic<int64_t>  max_gap_ns; ///< Longest interval between consecutive messages; reset by takeMaxGap()
+  };
+
+private:
+  boost::scoped_array<LogCounters> counters_;
+
+  boost::scoped_array<uint16_t> seen_ids_;     ///< IDs received so far, in order of first arrival.
+  std::atomic<size_t>           num_seen_ids_;
+
+  std::atomic<uint64_t> total_;
+  std::atomic<uint64_t> unknown_;
+  std::atomic<uint64_t> discarded_;
+
+  static int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static void increment(std::atomic<uint64_t>& counter, uint64_t n = 1)
+  {
+    // Single writer: no read-modify-write needed.
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+public:
+  Oem7LogStatistics():
+    counters_(new LogCounters[NUM_MSG_IDS]),
+    seen_ids_(new uint16_t[NUM_MSG_IDS]),
+    num_seen_ids_(0),
+    total_(0),
+    unknown_(0),
+    discarded_(0)
+  {
+    for(size_t id = 0; id < NUM_MSG_IDS; id++)
+    {
+      counters_[id].count      = 0;
+      counters_[id].bytes      = 0;
+      counters_[id].last_ns    = 0;
+      counters_[id].max_gap_ns = 0;
+    }
+  }
+
+  /**
+   * Counts a log; decoder thread only.
+   */
+  void addLog(int msg_id, size_t len)
+  {
+    increment(total_);
+
+    LogCounters& c = counters_[static_cast<uint16_t>(msg_id)];
+
+    const uint64_t count = c.count.load(std::memory_order_relaxed);
+    if(count == 0)
+    {
+      const size_t num_seen = num_seen_ids_.load(std::memory_order_relaxed);
+      seen_ids_[num_seen] = msg_id;
+      num_seen_ids_.store(num_seen + 1, std::memory_order_release);
+    }
+
+    const int64_t t = now();
+    if(count > 0)
+    {
+      // Racing with a reset may carry a gap into the next window; harmless for monitoring.
+      const int64_t gap = t - c.last_ns.load(std::memory_order_relaxed);
+      if(gap > c.max_gap_ns.load(std::memory_order_relaxed))
+      {
+        c.max_gap_ns.store(gap, std::memory_order_relaxed);
+      }
+    }
+    c.last_ns.store(t, std::memory_order_relaxed);
+
+    increment(c.bytes, len);
+    c.count.store(count + 1, std::memory_order_relaxed);
+  }
+
+  void addUnknown()
+  {
+    increment(unknown_);
+  }
+
+  void addDiscarded()
+  {
+    increment(discarded_);
+  }
+
+  uint64_t getTotal()     const { return total_;     }
+  uint64_t getUnknown()   const { return unknown_;   }
+  uint64_t getDiscarded() const { return discarded_; }
+
+  /**
+   * Obtains IDs of all messages received so far.
+   */
+  void getSeenIds(std::vector<int>& ids) const
+  {
+    const size_t num_seen = num_seen_ids_.load(std::memory_order_acquire);
+    ids.assign(seen_ids_.get(), seen_ids_.get() + num_seen);
+  }
+
+  const LogCounters& getCounters(int msg_id) const
+  {
+    return counters_[static_cast<uint16_t>(msg_id)];
+  }
+
+  /**
+   * @return longest interval between messages since the previous call, ns.
+   */
+  int64_t takeMaxGap(int msg_id)
+  {
+    return counters_[static_cast<uint16_t>(msg_id)].max_gap_ns.exchange(0, std::memory_order_relaxed);
+  }
+};
+
+}
+#endif
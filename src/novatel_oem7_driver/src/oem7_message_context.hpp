@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_MESSAGE_CONTEXT_HPP__
+#define __OEM7_MESSAGE_CONTEXT_HPP__
+
+#include <ros/ros.h>
+
+#include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <oem7_latency.hpp>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Context of the Oem7 message being handled on this thread.
+   *
+   * A raw message is stamped with the arrival of the receiver input that completed it; the decoder keeps the arrival
+   * of its latest input, and passes it with each message (Oem7MessageDecoderUserIf::onNewStampedMessage).
+   * While a raw message is handled, its stamp is installed here (Oem7MessageScope), so that all ROS messages derived
+   * from it share the stamp.
+   */
+  struct Oem7MessageContext
+  {
+    ros::Time stamp; ///< Arrival of the raw message being handled; zero: none, e.g. in a timer callback.
+
+    static Oem7MessageContext& current()
+    {
+      static thread_local Oem7MessageContext ctx;
+      return ctx;
+    }
+
+    /**
+     * @return stamp of the raw message being handled; or the current time if none.
+     */
+    ros::Time getStamp() const
+    {
+      return stamp.isZero() ? ros::Time::now() : stamp;
+    }
+  };
+
+
+  /**
+   * Installs the stamp of a raw message in this thread's context while it is handled.
+   */
+  class Oem7MessageScope
+  {
+    Oem7MessageContext& ctx_;
+    const ros::Time     prev_stamp_;
+
+  public:
+    explicit Oem7MessageScope(const ros::Time& stamp):
+      ctx_(Oem7MessageContext::current()),
+      prev_stamp_(ctx_.stamp)
+    {
+      ctx_.stamp = stamp;
+    }
+
+    ~Oem7MessageScope()
+    {
+      ctx_.stamp = prev_stamp_;
+    }
+  };
+
+
+  /**
+   * @return arrival of the input just returned by recvr.read(): as buffered by the receiver, or now.
+   */
+  inline Oem7InputArrival getOem7ReadArrival(const Oem7ReceiverIf& recvr)
+  {
+    Oem7InputArrival arrival = recvr.getReadArrival();
+    if(arrival.stamp.isZero())
+    {
+      arrival.stamp = ros::Time::now();
+    }
+    if(arrival.mono_ns == 0)
+    {
+      arrival.mono_ns = OEM7_LATENCY_NOW();
+    }
+    return arrival;
+  }
+}
+
+#endif
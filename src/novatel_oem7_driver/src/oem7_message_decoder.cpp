@@ -32,6 +32,9 @@
 #include "oem7_message_decoder_lib.hpp"
 
 #include "oem7_debug_file.hpp"
+#include "oem7_latency.hpp"
+#include "oem7_message_context.hpp"
+#include "oem7_param_cache.hpp"
 
 
 
@@ -53,6 +56,8 @@ namespace novatel_oem7_driver
 
     Oem7ReceiverIf* recvr_;
 
+    Oem7InputArrival read_arrival_; ///< Arrival of the latest input read; messages completed now arrived then.
+
     boost::shared_ptr<novatel_oem7::Oem7MessageDecoderLibIf> decoder_; //< NovAtel message decoder
 
 
@@ -79,8 +84,8 @@ namespace novatel_oem7_driver
 
       std::string decoder_dbg_file_name;
       std::string receiver_dbg_file_name;
-      nh_.getParam("oem7_receiver_log_file", receiver_dbg_file_name);
-      nh_.getParam("oem7_decoder_log_file",  decoder_dbg_file_name);
+      getOem7Param(nh_, "oem7_receiver_log_file", receiver_dbg_file_name);
+      getOem7Param(nh_, "oem7_decoder_log_file",  decoder_dbg_file_name);
       
       decoder_dbg_file_.initialize( decoder_dbg_file_name);
       receiver_dbg_file_.initialize(receiver_dbg_file_name);
@@ -92,8 +97,10 @@ namespace novatel_oem7_driver
     virtual bool read( boost::asio::mutable_buffer buf, size_t& s)
     {
       bool ok = recvr_->read(buf, s);
-      if(ok)
+      if(ok && s > 0)
       {
+        read_arrival_ = getOem7ReadArrival(*recvr_);
+
         receiver_dbg_file_.write(boost::asio::buffer_cast<unsigned char*>(buf), s);
       }
 
@@ -121,7 +128,7 @@ namespace novatel_oem7_driver
             {
               decoder_dbg_file_.write(msg->getMessageData(0), msg->getMessageDataLength());
 
-              user_->onNewMessage(msg);
+              user_->onNewStampedMessage(msg, read_arrival_);
             }
             // else: No messages available now; keep retrying until we get one or decoder gives up.
           }
@@ -137,6 +144,45 @@ namespace novatel_oem7_driver
         ROS_ERROR_STREAM("Decoder exception: " << ex.what());
       }
     }
+
+    bool supportsServiceAvailable() const
+    {
+      return true;
+    }
+
+    bool serviceAvailable(size_t max_msgs)
+    {
+      try
+      {
+        for(size_t num_msgs = 0;
+                   num_msgs < max_msgs && !ros::isShuttingDown();
+                   num_msgs++)
+        {
+          boost::shared_ptr<novatel_oem7::Oem7RawMessageIf> msg;
+          if(!decoder_->readMessage(msg))
+          {
+            ROS_WARN("Decoder: no more messages available.");
+            return false;
+          }
+
+          if(!msg)
+          {
+            return true; // No complete messages in the input available now.
+          }
+
+          decoder_dbg_file_.write(msg->getMessageData(0), msg->getMessageDataLength());
+
+          user_->onNewStampedMessage(msg, read_arrival_);
+        }
+      }
+      catch(std::exception const& ex)
+      {
+        ROS_ERROR_STREAM("Decoder exception: " << ex.what());
+        return false;
+      }
+
+      return !ros::isShuttingDown();
+    }
   };
 
 }
@@ -27,24 +27,28 @@
 #include <ros/callback_queue.h>
 
 #include <mutex>
-#include <condition_variable>
-#include <map>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <future>
 
 #include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
 
-#include "novatel_oem7_msgs/Oem7AbasciiCmd.h"
-#include "novatel_oem7_msgs/Oem7RawMsg.h"
+#include "diagnostic_msgs/DiagnosticArray.h"
 
 #include <pluginlib/class_loader.h>
 
-#include <novatel_oem7_driver/oem7_receiver_if.hpp>
-#include <novatel_oem7_driver/oem7_message_decoder_if.hpp>
-
 #include <novatel_oem7_driver/oem7_message_util.hpp>
-#include <novatel_oem7_driver/ros_messages.hpp>
 #include <oem7_ros_publisher.hpp>
-
-#include <message_handler.hpp>
+#include <oem7_ros_message_pool.hpp>
+#include <oem7_latency.hpp>
+#include <oem7_receiver_session.hpp>
+#include <oem7_param_cache.hpp>
+#include <oem7_startup.hpp>
 
 
 namespace novatel_oem7_driver
@@ -53,52 +57,43 @@ namespace novatel_oem7_driver
    * Nodelet publishing raw oem7 messages and issuing oem7 commands.
    * Loads plugins responsible for obtaining byte input from the Oem7 receiver, and decoding it into raw oem7 messages.
    * Implements a service allowing Oem7 Abbreviated ASCII commands to be sent to the receiver.
+   *
+   * Serves a single receiver, configured in the private namespace; or, when 'oem7_receivers' lists receiver names,
+   * several receivers, each configured in its own private sub-namespace, decoded on a shared pool of worker threads.
    */
   class Oem7MessageNodelet :
-      public Oem7MessageDecoderUserIf,
       public nodelet::Nodelet
   {
     std::mutex nodelet_mtx_; ///< Protects nodelet internal state
 
-    double publish_delay_sec_; ///< Delay after publishing each message; used to throttle output with static data sources.
-
-    Oem7RosPublisher oem7rawmsg_pub_; ///< Publishes raw Oem7 messages.
-    bool publish_unknown_oem7raw_; ///< Publish all unknown messages to 'Oem7Raw'
+#ifdef OEM7_LATENCY_INSTRUMENTATION
+    Oem7RosPublisher latency_pub_;   ///< Publishes latency diagnostics.
+    ros::Timer       latency_timer_; ///< Latency diagnostics period; each period is a new histogram window.
+#endif
 
-    ros::CallbackQueue timer_queue_; ///< Dedicated queue for command requests.
-    boost::shared_ptr<ros::AsyncSpinner> timer_spinner_; ///< 1 thread servicing the command queue.
+    ros::CallbackQueue timer_queue_; ///< Dedicated queue for the service loop.
+    boost::shared_ptr<ros::AsyncSpinner> timer_spinner_; ///< 1 thread servicing the service loop.
 
-    // Command service
-    std::condition_variable rsp_ready_cond_; ///< Response ready, signaled from response handler to Oem7 Cmd Handler.
-    std::mutex              rsp_ready_mtx_; ///< Response condition guard
-    std::string rsp_; ///< The latest response from Oem7 receiver.
     ros::CallbackQueue queue_; //< Dedicated queue for command requests.
-    boost::shared_ptr<ros::AsyncSpinner> aspinner_; ///< 1 thread servicing the command queue.
-    ros::ServiceServer oem7_cmd_srv_; ///< Oem7 command service.
+    boost::shared_ptr<ros::AsyncSpinner> aspinner_; ///< Threads servicing the command queue; 1 per receiver.
 
 
     ros::Timer timer_; ///< One time service callback.
 
-    pluginlib::ClassLoader<novatel_oem7_driver::Oem7ReceiverIf> recvr_loader_;
-    pluginlib::ClassLoader<novatel_oem7_driver::Oem7MessageDecoderIf> oem7_msg_decoder_loader;
-
-    std::set<int> raw_msg_pub_; ///< Set of raw messages to publish.
-
-    boost::shared_ptr<MessageHandler> msg_handler_; ///< Dispatches individual messages for handling.
-
-    // Log statistics
-    long total_log_count_; ///< Total number of logs received
+    boost::scoped_ptr<Oem7RuntimeParamSnapshot> runtime_params_; ///< Tables handlers consult at runtime; outlives them.
 
-    typedef std::map<int, long> log_count_map_t;
-    log_count_map_t log_counts_; ///< Indidividual log counts.
-    
-    long unknown_msg_num_;   ///< number of messages received that could not be identified.
-    long discarded_msg_num_; ///< Number of messages received and discarded by the driver.
+    Oem7ReceiverLoader       recvr_loader_;
+    Oem7MessageDecoderLoader oem7_msg_decoder_loader;
 
+    std::vector<boost::shared_ptr<Oem7ReceiverSession> > sessions_; ///< Receivers served by this nodelet.
 
-    boost::shared_ptr<novatel_oem7_driver::Oem7MessageDecoderIf> msg_decoder; ///< Message Decoder plugin
-    boost::shared_ptr<novatel_oem7_driver::Oem7ReceiverIf> recvr_; ///< Oem7 Receiver Interface plugin
+    // Multiple receivers: decoding worker pool.
+    boost::asio::io_service                        workers_io_;
+    boost::scoped_ptr<boost::asio::io_service::work> workers_work_; ///< Keeps workers running while idle.
+    std::vector<std::thread>                       workers_;
+    std::atomic<size_t>                            num_finished_sessions_;
 
+    Oem7ReadinessLatch threads_ready_; ///< Decoding threads started.
 
 
     /**
@@ -128,280 +123,229 @@ namespace novatel_oem7_driver
 
       std::lock_guard<std::mutex> guard(nodelet_mtx_);
 
+      Oem7StartupTimer startup;
 
-      initializeOem7MessageUtil(getNodeHandle());
-
-      getNodeHandle().setCallbackQueue(&timer_queue_);
-
-      getPrivateNodeHandle().getParam("oem7_publish_unknown_oem7raw", publish_unknown_oem7raw_);
-
-      getPrivateNodeHandle().getParam("oem7_publish_delay", publish_delay_sec_);
-      if(publish_delay_sec_ > 0)
+      // Configuration is read at startup: obtain this nodelet's in one round trip, instead of one per parameter.
+      const Oem7ParamSnapshot params(getPrivateNodeHandle().getNamespace());
+      if(!params.isLoaded())
       {
-        NODELET_WARN_STREAM("Publish Delay: " << publish_delay_sec_ << " seconds. Is this is a test?");
+        NODELET_WARN_STREAM("Parameters of '" << getPrivateNodeHandle().getNamespace() << "' not cached.");
       }
-      // Load plugins
+      runtime_params_.reset(new Oem7RuntimeParamSnapshot);
 
-      // Load Oem7Receiver
-      std::string oem7_if_name;
-      getPrivateNodeHandle().getParam("oem7_if", oem7_if_name);
-      recvr_ = recvr_loader_.createInstance(oem7_if_name);
-      recvr_->initialize(getPrivateNodeHandle());
+      initializeOem7MessageUtil(getNodeHandle());
 
-      // Load Oem7 Message Decoder
-      std::string msg_decoder_name;
-      getPrivateNodeHandle().getParam("oem7_msg_decoder", msg_decoder_name);
-      msg_decoder = oem7_msg_decoder_loader.createInstance(msg_decoder_name);
-      msg_decoder->initialize(getPrivateNodeHandle(), recvr_.get(), this);
+      getNodeHandle().setCallbackQueue(&timer_queue_);
 
+      int msg_pool_size = Oem7RosMessagePoolRegistry::instance().getCapacity();
+      getOem7Param(getPrivateNodeHandle(), "oem7_msg_pool_size", msg_pool_size);
+      Oem7RosMessagePoolRegistry::instance().setCapacity(std::max(msg_pool_size, 0));
 
-      msg_handler_.reset(new MessageHandler(getPrivateNodeHandle()));
+      std::vector<std::string> receivers;
+      getOem7Param(getPrivateNodeHandle(), "oem7_receivers", receivers);
+      const bool pooled = !receivers.empty();
 
-      // Oem7 raw messages to publish.
-      std::vector<std::string> oem7_raw_msgs;
-      bool ok = getPrivateNodeHandle().getParam("oem7_raw_msgs", oem7_raw_msgs);
-      for(const auto& msg : oem7_raw_msgs)
+      if(!pooled)
       {
-        int raw_msg_id = getOem7MessageId(msg);
-        if(raw_msg_id == 0)
-        {
-          NODELET_ERROR_STREAM("Unknown Oem7 message '" << msg );
-        }
-        else
+        sessions_.push_back(boost::make_shared<Oem7ReceiverSession>(getName(), getPrivateNodeHandle()));
+      }
+      else
+      {
+        for(const auto& receiver: receivers)
         {
-          NODELET_INFO_STREAM("Oem7 Raw message '" << msg << "' will be published." );
-          raw_msg_pub_.insert(raw_msg_id);
+          ros::NodeHandle nh(getPrivateNodeHandle(), receiver);
+          if(!Oem7ParamCache::instance().hasParam(nh, "oem7_topic_prefix"))
+          {
+            Oem7ParamCache::instance().setParam(nh, "oem7_topic_prefix", "/" + receiver); // Keep topics of receivers apart.
+          }
+
+          sessions_.push_back(boost::make_shared<Oem7ReceiverSession>(getName() + "/" + receiver, nh));
         }
       }
 
-      oem7rawmsg_pub_.setup<novatel_oem7_msgs::Oem7RawMsg>("Oem7RawMsg", getPrivateNodeHandle());
+      startup.endPhase("parameters");
 
-      timer_spinner_.reset(new ros::AsyncSpinner(1, &timer_queue_)); //< 1 thread servicing the command queue.
-      timer_spinner_->start();
-
-      timer_ =  getNodeHandle().createTimer(ros::Duration(0.0), &Oem7MessageNodelet::serviceLoopCb, this, true);
+      // Receivers are independent: initialize them concurrently.
+      std::vector<std::future<void> > initialized;
+      for(const auto& session: sessions_)
+      {
+        initialized.push_back(std::async(std::launch::async,
+                                         [this, session, pooled]()
+                                         {
+                                           session->initialize(recvr_loader_, oem7_msg_decoder_loader, &queue_, pooled);
+                                         }));
+      }
+      for(auto& init: initialized)
+      {
+        init.get(); // Rethrows initialization errors.
+      }
 
-      aspinner_.reset(new ros::AsyncSpinner(1, &queue_));
-      aspinner_->start();
+      startup.endPhase("receivers");
 
-      sleep(0.5); // Allow all threads to start
+#ifdef OEM7_LATENCY_INSTRUMENTATION
+      latency_pub_.setup<diagnostic_msgs::DiagnosticArray>("LatencyDiagnostics", getPrivateNodeHandle());
 
-      ros::AdvertiseServiceOptions ops = ros::AdvertiseServiceOptions::create<novatel_oem7_msgs::Oem7AbasciiCmd>(
-                                                            "Oem7Cmd",
-                                                            boost::bind(&Oem7MessageNodelet::serviceOem7AbasciiCb, this, _1, _2),
-                                                            ros::VoidConstPtr(),
-                                                            &queue_);
-      oem7_cmd_srv_ = getPrivateNodeHandle().advertiseService(ops);
-    }
+      double latency_period = 1.0;
+      getOem7Param(getPrivateNodeHandle(), "oem7_latency_diagnostics_period", latency_period);
+      // Not on the timer queue; its only thread runs the service loop.
+      latency_timer_ = getPrivateNodeHandle().createTimer(ros::Duration(latency_period),
+                                                          &Oem7MessageNodelet::publishLatencyCb, this);
+      NODELET_WARN_STREAM("Latency instrumentation enabled; period: " << latency_period << " s");
+#endif
 
+      if(pooled)
+      {
+        int num_workers = std::min<size_t>(sessions_.size(), std::max(std::thread::hardware_concurrency(), 1u));
+        getOem7Param(getPrivateNodeHandle(), "oem7_decode_threads", num_workers);
+        num_workers = std::max(num_workers, 1);
 
-    /**
-     * Called to request O7AbasciiCmd service
-     */
-    bool serviceOem7AbasciiCb(novatel_oem7_msgs::Oem7AbasciiCmd::Request& req, novatel_oem7_msgs::Oem7AbasciiCmd::Response& rsp)
-    {
-      NODELET_DEBUG_STREAM("AACmd: cmd '" << req.cmd << "'");
+        NODELET_INFO_STREAM("Receivers: " << sessions_.size() << "; decode threads: " << num_workers);
 
-      // Retry sending the commands. For configuration commands, there is no harm in duplicates.
-      for(int attempt = 0;
-              attempt < 10;
-              attempt++)
-      {
+        workers_work_.reset(new boost::asio::io_service::work(workers_io_));
+        threads_ready_.expect(num_workers);
+        for(int w = 0; w < num_workers; w++)
         {
-          std::lock_guard<std::mutex> lk(rsp_ready_mtx_);
-    	  rsp_.clear();
-    	}
-
-        recvr_->write(boost::asio::buffer(req.cmd));
-        static const std::string NEWLINE("\n");
-        recvr_->write(boost::asio::buffer(NEWLINE));
-
-        std::unique_lock<std::mutex> lk(rsp_ready_mtx_);
-        if(rsp_ready_cond_.wait_until(lk,
-                                      std::chrono::steady_clock::now() + std::chrono::seconds(3)
-                                      ) == std::cv_status::no_timeout)
-        {
-          rsp.rsp = rsp_;
-          break;
+          workers_.push_back(std::thread([this](){ threads_ready_.ready(); workers_io_.run(); }));
         }
 
-        NODELET_ERROR_STREAM("Attempt " << attempt << ": timed out waiting for response.");
-      }
-
-      if(rsp.rsp == "OK")
-      {
-        NODELET_INFO_STREAM("AACmd '" << req.cmd << "' : " << "'" << rsp.rsp << "'");
+        for(const auto& session: sessions_)
+        {
+          session->start(workers_io_, boost::bind(&Oem7MessageNodelet::onSessionFinished, this));
+        }
       }
       else
       {
-        NODELET_ERROR_STREAM("AACmd '" << req.cmd << "' : " << "'" << rsp.rsp << "'");
-      }
-
-      return true;
-    }
+        timer_spinner_.reset(new ros::AsyncSpinner(1, &timer_queue_)); //< 1 thread servicing the service loop.
+        timer_spinner_->start();
 
-    /**
-     * Outputs Log statistics to ROS console.
-     */
-    void outputLogStatistics()
-    {
-      NODELET_INFO("Log Statistics:");
-      NODELET_INFO_STREAM("Logs: " << total_log_count_ << "; unknown: "   << unknown_msg_num_
-                                                       << "; discarded: " << discarded_msg_num_);
+        threads_ready_.expect(1);
 
-      for(log_count_map_t::iterator itr = log_counts_.begin();
-                                    itr != log_counts_.end();
-                                    itr++)
-      {
-        int  id    = itr->first;
-        long count = itr->second;
-
-        NODELET_INFO_STREAM("Log[" << getOem7MessageName(id) << "](" << id << "):" <<  count);
+        timer_ =  getNodeHandle().createTimer(ros::Duration(0.0), &Oem7MessageNodelet::serviceLoopCb, this, true);
       }
-    }
 
-    /*
-     * Update Log statistics for a particular message
-     */
-    void updateLogStatistics(const Oem7RawMessageIf::ConstPtr& raw_msg)
-    {
-      total_log_count_++;
+      // Commands to different receivers do not wait for each other.
+      aspinner_.reset(new ros::AsyncSpinner(sessions_.size(), &queue_));
+      aspinner_->start();
 
-      if(log_counts_.find(raw_msg->getMessageId()) == log_counts_.end())
+      if(!threads_ready_.wait(5.0))
       {
-        log_counts_[raw_msg->getMessageId()] = 0;
+        NODELET_WARN("Decoding threads not started yet.");
       }
-      log_counts_[raw_msg->getMessageId()]++;
+      startup.endPhase("threads");
 
+      NODELET_INFO_STREAM("Startup: " << startup.getBreakdown());
+    }
 
-      if((total_log_count_ % 10000) == 0)
+    /**
+     * Outputs message pool statistics to ROS console.
+     */
+    void outputPoolStatistics()
+    {
+      std::vector<Oem7RosMessagePoolStats> pool_stats;
+      Oem7RosMessagePoolRegistry::instance().getStats(pool_stats);
+      for(size_t i = 0; i < pool_stats.size(); i++)
       {
-        outputLogStatistics();
+        const Oem7RosMessagePoolStats& stats = pool_stats[i];
+        NODELET_INFO_STREAM("Msg pool[" << stats.type << "]: hits: " << stats.hits
+                                          << "; misses: "   << stats.misses
+                                          << "; recycled: " << stats.recycled
+                                          << "; dropped: "  << stats.dropped
+                                          << "; free: "     << stats.free);
       }
     }
 
-    void publishOem7RawMsg(Oem7RawMessageIf::ConstPtr raw_msg)
-    {
-        novatel_oem7_msgs::Oem7RawMsg::Ptr oem7_raw_msg(new novatel_oem7_msgs::Oem7RawMsg);
-        oem7_raw_msg->message_data.insert(
-                                        oem7_raw_msg->message_data.end(),
-                                        raw_msg->getMessageData(0),
-                                        raw_msg->getMessageData(raw_msg->getMessageDataLength()));
-
-        assert(oem7_raw_msg->message_data.size() == raw_msg->getMessageDataLength());
-
-        oem7rawmsg_pub_.publish(oem7_raw_msg);
-    } 
-
-
-   /**
-     * Called by ROS decoder with new raw messages
+#ifdef OEM7_LATENCY_INSTRUMENTATION
+    /**
+     * Publishes latency percentiles per message ID, over the period since the previous call.
      */
-    void onNewMessage(Oem7RawMessageIf::ConstPtr raw_msg)
+    void publishLatencyCb(const ros::TimerEvent&)
     {
-      NODELET_DEBUG_STREAM("onNewMsg: fmt= " << raw_msg->getMessageFormat()
-                              <<   " type= " << raw_msg->getMessageType());
+      Oem7LatencyRecorder::LatencyMap window;
+      Oem7LatencyRecorder::instance().takeWindow(window);
 
-      // Discard all unknown messages; this is normally when dealing with responses to ASCII commands.
-      if(raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_UNKNOWN)
-      {
-        ++unknown_msg_num_;
-        NODELET_DEBUG_STREAM("Unknown:    [ID: "   << raw_msg->getMessageId()          <<
-                                          "Type: " << raw_msg->getMessageType()        <<
-                                          "Fmt: "  << raw_msg->getMessageFormat()      <<
-                                          "Len: "  << raw_msg->getMessageDataLength()  <<
-                                          "]");
-        if(publish_unknown_oem7raw_)
-        {
-            publishOem7RawMsg(raw_msg);
-        }
-        else
-        {
-            ++discarded_msg_num_;
-        }
-      }
-      else
+      boost::shared_ptr<diagnostic_msgs::DiagnosticArray> diag(new diagnostic_msgs::DiagnosticArray);
+      for(const auto& msg_latency: window)
       {
-        if(raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_ASCII  ||
-           raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_ABASCII)
-        {
-          std::string msg(raw_msg->getMessageData(0), raw_msg->getMessageData(raw_msg->getMessageDataLength()));
+        diagnostic_msgs::DiagnosticStatus status;
+        status.level       = diagnostic_msgs::DiagnosticStatus::OK;
+        status.name        = getName() + ": latency: " + getOem7MessageName(msg_latency.first);
+        status.hardware_id = std::to_string(msg_latency.first);
 
-          NODELET_DEBUG_STREAM(">---------------------------" << std::endl
-                            << msg                            << std::endl
-                            << "<---------------------------");
-        }
-
-        if(raw_msg->getMessageType() == Oem7RawMessageIf::OEM7MSGTYPE_RSP) // Response
+        for(int i = 0; i < Oem7LatencyRecorder::NUM_INTERVALS; i++)
         {
-          std::string rsp(raw_msg->getMessageData(0), raw_msg->getMessageData(raw_msg->getMessageDataLength()));
-          if(rsp.find_first_not_of(" /t/r/n") != std::string::npos && // ignore all-whitespace responses
-             std::all_of(rsp.begin(), rsp.end(), [](char c){return std::isprint(c);})) // Ignore any corrupt responses
-          {
-            {
-              std::lock_guard<std::mutex> lk(rsp_ready_mtx_);
-              rsp_ = rsp;
-            }
-            rsp_ready_cond_.notify_one();
-          }
-          else
-          {
-            NODELET_ERROR_STREAM("Discarded corrupt ASCII response: '" << rsp_ << "'");
-          }
-        }
-        else // Log
-        {
-          if( raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_BINARY  || // binary
-             (raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_ASCII && isNMEAMessage(raw_msg)))
-          {
-            updateLogStatistics(raw_msg);
+          const Oem7LatencyHistogram& hist = msg_latency.second.interval[i];
+          if(hist.count() == 0)
+            continue;
 
-            msg_handler_->handleMessage(raw_msg);
+          const std::string name = Oem7LatencyRecorder::getIntervalName(i);
 
-            // Publish Oem7RawMsg if specified
-            if(raw_msg_pub_.find(raw_msg->getMessageId()) != raw_msg_pub_.end())
-            {
-                publishOem7RawMsg(raw_msg);
-            }
+          diagnostic_msgs::KeyValue kv;
+          kv.key = name + " p50 [us]"; kv.value = std::to_string(hist.percentile(0.50) / 1000.0); status.values.push_back(kv);
+          kv.key = name + " p99 [us]"; kv.value = std::to_string(hist.percentile(0.99) / 1000.0); status.values.push_back(kv);
+          kv.key = name + " max [us]"; kv.value = std::to_string(hist.max()            / 1000.0); status.values.push_back(kv);
 
-            if(publish_delay_sec_ > 0)
-            {
-              sleep(publish_delay_sec_);
-            }
+          if(i == Oem7LatencyRecorder::READ_TO_PUBLISH)
+          {
+            status.message = std::to_string(hist.count()) + " published";
           }
         }
+
+        diag->status.push_back(status);
       }
-    }
 
+      latency_pub_.publish(diag);
+    }
+#endif
 
     /**
-     * Service loop; drives Oem7 message decoder. onNewMessage is called on this thread.
+     * Service loop; drives the decoder of the single receiver. Messages are handled on this thread.
      */
     void serviceLoopCb(const ros::TimerEvent& event)
     {
-      msg_decoder->service();
+      threads_ready_.ready();
+
+      sessions_.front()->service();
 
-      outputLogStatistics();
+      outputPoolStatistics();
 
       NODELET_WARN("No more input from Decoder; Oem7MessageNodelet finished.");
     }
 
+    /**
+     * Called on a worker thread when a receiver session runs out of input.
+     */
+    void onSessionFinished()
+    {
+      if(++num_finished_sessions_ == sessions_.size())
+      {
+        outputPoolStatistics();
+
+        NODELET_WARN("No more input from any receiver; Oem7MessageNodelet finished.");
+      }
+    }
+
 
   public:
     Oem7MessageNodelet():
       recvr_loader_(          "novatel_oem7_driver", "novatel_oem7_driver::Oem7ReceiverIf"),
       oem7_msg_decoder_loader("novatel_oem7_driver", "novatel_oem7_driver::Oem7MessageDecoderIf"),
-      total_log_count_(0),
-      unknown_msg_num_(0),
-      discarded_msg_num_(0),
-      publish_delay_sec_(0),
-      publish_unknown_oem7raw_(false)
+      num_finished_sessions_(0)
     {
     }
 
     ~Oem7MessageNodelet()
     {
       NODELET_DEBUG("~Oem7MessageNodelet");
+
+      // Workers call into sessions: stop them first.
+      workers_work_.reset();
+      workers_io_.stop();
+      for(auto& worker: workers_)
+      {
+        worker.join();
+      }
+
+      sessions_.clear();
     }
   };
 }
@@ -25,6 +25,7 @@
 #include <novatel_oem7_driver/oem7_message_util.hpp>
 
 #include "novatel_oem7_driver/oem7_messages.h"
+#include <oem7_param_cache.hpp>
 
 
 namespace
@@ -50,7 +51,7 @@ namespace novatel_oem7_driver
       return;
 
     const std::string ns(ros::this_node::getNamespace());
-    nh.getParam(ns + "/oem7_msgs", oem7_msg_id_map);
+    getOem7Param(nh, ns + "/oem7_msgs", oem7_msg_id_map);
     for(const auto& msg_itr : oem7_msg_id_map)
     {
       ROS_DEBUG_STREAM("Oem7 Message: " << msg_itr.first << ":" << msg_itr.second);
@@ -62,7 +63,9 @@ namespace novatel_oem7_driver
 
   int getOem7MessageId(const std::string& msg_name)
   {
-    return oem7_msg_id_map[msg_name];
+    // Lookup only; safe for concurrent use once initialized.
+    std::map<std::string, int>::const_iterator itr = oem7_msg_id_map.find(msg_name);
+    return itr == oem7_msg_id_map.end() ? 0 : itr->second;
   }
 
   const std::string& getOem7MessageName(int msg_id)
@@ -116,6 +119,43 @@ namespace novatel_oem7_driver
                      raw_msg->getMessageId()) != OEM7_NMEA_MSGIDS.end();
   }
 
+  bool getOem7MessageGPSTime(
+      const Oem7RawMessageIf::ConstPtr& raw_msg,
+      uint16_t& gps_week,
+      uint32_t& gps_milliseconds)
+  {
+    static const uint8_t OEM7_BINARY_SYNC3       = 0x12;
+    static const uint8_t OEM7_SHORT_BINARY_SYNC3 = 0x13;
+
+    if(raw_msg->getMessageFormat() != Oem7RawMessageIf::OEM7MSGFMT_BINARY ||
+       raw_msg->getMessageDataLength() < OEM7_BINARY_MSG_SHORT_HDR_LEN)
+    {
+      return false;
+    }
+
+    const Oem7MessageCommonHeaderMem* common_hdr =
+        reinterpret_cast<const Oem7MessageCommonHeaderMem*>(raw_msg->getMessageData(0));
+
+    if(static_cast<uint8_t>(common_hdr->sync3) == OEM7_SHORT_BINARY_SYNC3)
+    {
+      const Oem7MessgeShortHeaderMem* hdr_mem = reinterpret_cast<const Oem7MessgeShortHeaderMem*>(common_hdr);
+      gps_week         = hdr_mem->gps_week;
+      gps_milliseconds = hdr_mem->gps_milliseconds;
+      return true;
+    }
+
+    if(static_cast<uint8_t>(common_hdr->sync3) == OEM7_BINARY_SYNC3 &&
+       raw_msg->getMessageDataLength() >= OEM7_BINARY_MSG_HDR_LEN)
+    {
+      const Oem7MessageHeaderMem* hdr_mem = reinterpret_cast<const Oem7MessageHeaderMem*>(common_hdr);
+      gps_week         = hdr_mem->gps_week;
+      gps_milliseconds = hdr_mem->gps_milliseconds;
+      return true;
+    }
+
+    return false;
+  }
+
   size_t Get_INSCONFIG_NumTranslations(const INSCONFIG_FixedMem* insconfig)
   {
     const uint8_t* mem = reinterpret_cast<const uint8_t*>(insconfig) + sizeof(INSCONFIG_FixedMem);
@@ -172,6 +212,20 @@ namespace novatel_oem7_driver
     return reinterpret_cast<const PSRDOP2_SystemMem*>(mem);
   }
 
+  size_t Get_RANGE_NumObservations(const RANGE_FixedMem* range)
+  {
+    return range->num_obs;
+  }
+
+  const RANGE_ObservationMem* Get_RANGE_Observation(const RANGE_FixedMem* range, size_t idx)
+  {
+    const uint8_t* mem = reinterpret_cast<const uint8_t*>(range) +
+                    sizeof(RANGE_FixedMem) +
+                    sizeof(RANGE_ObservationMem) * idx;
+
+    return reinterpret_cast<const RANGE_ObservationMem*>(mem);
+  }
+
 
 }
 
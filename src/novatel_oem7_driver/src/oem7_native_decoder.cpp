@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <novatel_oem7_driver/oem7_message_decoder_if.hpp>
+#include <novatel_oem7_driver/oem7_receiver_if.hpp>
+
+#include <ros/console.h>
+
+
+#include <boost/scoped_ptr.hpp>
+#include "oem7_message_decoder_lib.hpp"
+
+#include "oem7_binary_framer.hpp"
+#include "oem7_debug_file.hpp"
+#include "oem7_latency.hpp"
+#include "oem7_message_context.hpp"
+#include "oem7_param_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+
+namespace novatel_oem7_driver
+{
+
+  /***
+   * Oem7 message decoder framing binary and short binary messages in-tree, without copying them; refer to
+   * Oem7BinaryFramer. All other input, e.g. ASCII and Abbreviated ASCII responses, ASCII logs and NMEA, is decoded by
+   * Oem7MessageDecoderLib, in order with the binary messages.
+   */
+  class Oem7NativeMessageDecoder: public Oem7MessageDecoderIf, public novatel_oem7::Oem7MessageDecoderLibUserIf
+  {
+    ros::NodeHandle nh_; // ROS Node Handle.
+
+    Oem7DebugFile decoder_dbg_file_;
+    Oem7DebugFile receiver_dbg_file_;
+
+
+    Oem7MessageDecoderUserIf* user_; //< Parser user callback interface
+
+    Oem7ReceiverIf* recvr_;
+
+    Oem7BinaryFramer framer_;
+
+    Oem7InputArrival read_arrival_; ///< Arrival of the latest input read; messages completed now arrived then.
+
+    boost::shared_ptr<novatel_oem7::Oem7MessageDecoderLibIf> decoder_; //< NovAtel message decoder, for non-binary input
+    std::vector<uint8_t> decoder_input_;     ///< Non-binary input, not yet read by decoder_
+    size_t               decoder_input_pos_; ///< Start of the input not yet read
+    bool                 decoder_pending_;   ///< decoder_ may have messages to return
+
+
+    void onNewMessage(const boost::shared_ptr<const novatel_oem7::Oem7RawMessageIf>& msg)
+    {
+      decoder_dbg_file_.write(msg->getMessageData(0), msg->getMessageDataLength());
+
+      user_->onNewStampedMessage(msg, read_arrival_);
+    }
+
+    /**
+     * Makes a callback for the next message in the input read so far.
+     *
+     * @return false if there are no complete messages in the input.
+     */
+    bool decodeBuffered()
+    {
+      for(;;)
+      {
+        // Non-binary messages preceding the binary message framed next.
+        while(decoder_pending_)
+        {
+          const size_t input_pos = decoder_input_pos_;
+
+          boost::shared_ptr<novatel_oem7::Oem7RawMessageIf> msg;
+          decoder_->readMessage(msg);
+          if(msg)
+          {
+            onNewMessage(msg);
+            return true;
+          }
+
+          decoder_pending_ = decoder_input_pos_ != input_pos; // No message, but the input was not exhausted.
+        }
+
+        novatel_oem7::Oem7RawMessageIf::ConstPtr frame;
+        const uint8_t* pass;
+        size_t         pass_len;
+        switch(framer_.next(frame, pass, pass_len))
+        {
+          case Oem7BinaryFramer::FRAME:
+            onNewMessage(frame);
+            return true;
+
+          case Oem7BinaryFramer::PASSTHROUGH:
+            decoder_input_.insert(decoder_input_.end(), pass, pass + pass_len);
+            decoder_pending_ = true;
+            break;
+
+          case Oem7BinaryFramer::NEED_INPUT:
+            return false;
+        }
+      }
+    }
+
+    /**
+     * Reads receiver input.
+     *
+     * @return false when no more input is available, as a permanent condition.
+     */
+    bool readInput(size_t& s)
+    {
+      boost::asio::mutable_buffer buf = framer_.prepare();
+
+      s = 0;
+      bool ok = recvr_->read(buf, s);
+      if(ok && s > 0)
+      {
+        read_arrival_ = getOem7ReadArrival(*recvr_);
+
+        receiver_dbg_file_.write(boost::asio::buffer_cast<unsigned char*>(buf), s);
+
+        framer_.commit(s);
+      }
+
+      return ok;
+    }
+
+    void outputStatistics()
+    {
+      ROS_INFO_STREAM("Decoder: binary messages: " << framer_.getNumFrames()
+                                   << "; CRC errors: " << framer_.getNumCRCErrors()
+                                   << "; non-binary bytes: " << framer_.getNumPassthroughBytes());
+    }
+
+  public:
+    Oem7NativeMessageDecoder():
+      user_(NULL),
+      recvr_(NULL),
+      decoder_input_pos_(0),
+      decoder_pending_(false)
+    {
+    }
+
+    /**
+     * Initializes the decoder
+     */
+    bool initialize(
+        ros::NodeHandle& nh,
+        Oem7ReceiverIf* recvr,
+        Oem7MessageDecoderUserIf* user)
+    {
+      nh_    = nh;
+      user_  = user;
+      recvr_ = recvr;
+
+      novatel_oem7::version_element_t major, minor, build;
+      novatel_oem7::GetOem7MessageDecoderLibVersion(major, minor, build);
+
+      ROS_INFO_STREAM("Native binary framing; non-binary input: Oem7MessageDecoderLib version: "
+                                                                  << major << "." << minor << "." << build);
+
+      decoder_ = novatel_oem7::GetOem7MessageDecoder(this);
+
+      std::string decoder_dbg_file_name;
+      std::string receiver_dbg_file_name;
+      getOem7Param(nh_, "oem7_receiver_log_file", receiver_dbg_file_name);
+      getOem7Param(nh_, "oem7_decoder_log_file",  decoder_dbg_file_name);
+
+      decoder_dbg_file_.initialize( decoder_dbg_file_name);
+      receiver_dbg_file_.initialize(receiver_dbg_file_name);
+
+
+      return true;
+    }
+
+    /**
+     * Input of Oem7MessageDecoderLib: the non-binary input. Does not block.
+     */
+    virtual bool read( boost::asio::mutable_buffer buf, size_t& s)
+    {
+      s = std::min(boost::asio::buffer_size(buf), decoder_input_.size() - decoder_input_pos_);
+      memcpy(boost::asio::buffer_cast<uint8_t*>(buf), decoder_input_.data() + decoder_input_pos_, s);
+
+      decoder_input_pos_ += s;
+      if(decoder_input_pos_ == decoder_input_.size())
+      {
+        decoder_input_.clear();
+        decoder_input_pos_ = 0;
+      }
+
+      return true;
+    }
+
+
+    /*
+     * Parser service loop.
+     * Drive the parser forward to keep reading from its input stream and making message callbacks into user.
+     * Blocks until:
+     * The system is shut down / ros::ok() returns false
+     * No more input available (as a permanent condition),
+     */
+    void service()
+    {
+      try
+      {
+        while(!ros::isShuttingDown())
+        {
+          if(decodeBuffered())
+            continue;
+
+          size_t s;
+          if(!readInput(s))
+          {
+            ROS_WARN("Decoder: no more messages available.");
+            break;
+          }
+        }
+      }
+      catch(std::exception const& ex)
+      {
+        ROS_ERROR_STREAM("Decoder exception: " << ex.what());
+      }
+
+      outputStatistics();
+    }
+
+    bool supportsServiceAvailable() const
+    {
+      return true;
+    }
+
+    bool serviceAvailable(size_t max_msgs)
+    {
+      try
+      {
+        size_t num_msgs = 0;
+        while(num_msgs < max_msgs && !ros::isShuttingDown())
+        {
+          if(decodeBuffered())
+          {
+            num_msgs++;
+            continue;
+          }
+
+          size_t s;
+          if(!readInput(s))
+          {
+            ROS_WARN("Decoder: no more messages available.");
+            outputStatistics();
+            return false;
+          }
+
+          if(s == 0)
+          {
+            return true; // No complete messages in the input available now.
+          }
+        }
+      }
+      catch(std::exception const& ex)
+      {
+        ROS_ERROR_STREAM("Decoder exception: " << ex.what());
+        return false;
+      }
+
+      return !ros::isShuttingDown();
+    }
+  };
+
+}
+
+#include <pluginlib/class_list_macros.h>
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::Oem7NativeMessageDecoder, novatel_oem7_driver::Oem7MessageDecoderIf)
@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include <oem7_param_cache.hpp>
+
+#include <cmath>
+#include <sstream>
+
+
+namespace novatel_oem7_driver
+{
+  bool Oem7ParamCache::load(const std::string& ns)
+  {
+    XmlRpc::XmlRpcValue params;
+    const bool loaded = ros::param::get(ns, params) && params.getType() == XmlRpc::XmlRpcValue::TypeStruct;
+
+    if(!loaded)
+      return false;
+
+    const std::string resolved = ros::names::resolve(ns);
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    snapshots_[resolved] = params;
+    ++refs_[resolved];
+
+    return true;
+  }
+
+  void Oem7ParamCache::release(const std::string& ns)
+  {
+    const std::string resolved = ros::names::resolve(ns);
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    std::map<std::string, int>::iterator itr = refs_.find(resolved);
+    if(itr == refs_.end())
+      return;
+
+    if(--itr->second == 0)
+    {
+      refs_.erase(itr);
+      snapshots_.erase(resolved);
+    }
+  }
+
+  bool Oem7ParamCache::isWithin(const std::string& name, const std::string& ns)
+  {
+    if(ns == "/")
+      return true;
+
+    return name.compare(0, ns.size(), ns) == 0 && (name.size() == ns.size() || name[ns.size()] == '/');
+  }
+
+  XmlRpc::XmlRpcValue* Oem7ParamCache::find(const std::string& name)
+  {
+    for(SnapshotMap::iterator itr = snapshots_.begin(); itr != snapshots_.end(); ++itr)
+    {
+      if(!isWithin(name, itr->first))
+        continue;
+
+      XmlRpc::XmlRpcValue* xml = &itr->second;
+
+      std::stringstream path(name.substr(itr->first.size()));
+      std::string key;
+      while(xml && std::getline(path, key, '/'))
+      {
+        if(key.empty())
+          continue;
+
+        if(xml->getType() != XmlRpc::XmlRpcValue::TypeStruct || !xml->hasMember(key))
+        {
+          xml = NULL;
+        }
+        else
+        {
+          xml = &(*xml)[key];
+        }
+      }
+
+      if(xml)
+        return xml;
+    }
+
+    return NULL;
+  }
+
+  bool Oem7ParamCache::hasParam(const ros::NodeHandle& nh, const std::string& name)
+  {
+    const std::string resolved = nh.resolveName(name);
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      if(find(resolved))
+      {
+        return true;
+      }
+    }
+
+    return nh.hasParam(name);
+  }
+
+  void Oem7ParamCache::setParam(const ros::NodeHandle& nh, const std::string& name, const std::string& value)
+  {
+    nh.setParam(name, value);
+
+    const std::string resolved = nh.resolveName(name);
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    for(SnapshotMap::iterator itr = snapshots_.begin(); itr != snapshots_.end(); ++itr)
+    {
+      if(!isWithin(resolved, itr->first))
+        continue;
+
+      XmlRpc::XmlRpcValue* xml = &itr->second;
+
+      std::stringstream path(resolved.substr(itr->first.size()));
+      std::string key;
+      while(std::getline(path, key, '/'))
+      {
+        if(key.empty())
+          continue;
+
+        if(xml->getType() != XmlRpc::XmlRpcValue::TypeStruct && xml->getType() != XmlRpc::XmlRpcValue::TypeInvalid)
+        {
+          *xml = XmlRpc::XmlRpcValue(); // Replaced by a namespace, as on the parameter server.
+        }
+
+        xml = &(*xml)[key]; // Creates the member, and a struct as needed.
+      }
+
+      *xml = value;
+    }
+  }
+
+  bool Oem7ParamCache::convert(XmlRpc::XmlRpcValue& xml, XmlRpc::XmlRpcValue& value)
+  {
+    value = xml;
+    return true;
+  }
+
+  bool Oem7ParamCache::convert(XmlRpc::XmlRpcValue& xml, std::string& value)
+  {
+    if(xml.getType() != XmlRpc::XmlRpcValue::TypeString)
+      return false;
+
+    value = static_cast<std::string&>(xml);
+    return true;
+  }
+
+  bool Oem7ParamCache::convert(XmlRpc::XmlRpcValue& xml, int& value)
+  {
+    if(xml.getType() == XmlRpc::XmlRpcValue::TypeInt)
+    {
+      value = static_cast<int>(xml);
+      return true;
+    }
+
+    if(xml.getType() == XmlRpc::XmlRpcValue::TypeDouble) // Rounded, as by ros::NodeHandle::getParam
+    {
+      double d = static_cast<double>(xml);
+      d = std::fmod(d, 1.0) < 0.5 ? std::floor(d) : std::ceil(d);
+      value = static_cast<int>(d);
+      return true;
+    }
+
+    return false;
+  }
+
+  bool Oem7ParamCache::convert(XmlRpc::XmlRpcValue& xml, double& value)
+  {
+    if(xml.getType() == XmlRpc::XmlRpcValue::TypeDouble)
+    {
+      value = static_cast<double>(xml);
+      return true;
+    }
+
+    if(xml.getType() == XmlRpc::XmlRpcValue::TypeInt)
+    {
+      value = static_cast<int>(xml);
+      return true;
+    }
+
+    return false;
+  }
+
+  bool Oem7ParamCache::convert(XmlRpc::XmlRpcValue& xml, bool& value)
+  {
+    if(xml.getType() != XmlRpc::XmlRpcValue::TypeBoolean)
+      return false;
+
+    value = static_cast<bool>(xml);
+    return true;
+  }
+}
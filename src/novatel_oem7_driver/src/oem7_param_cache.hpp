@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __OEM7_PARAM_CACHE_HPP__
+#define __OEM7_PARAM_CACHE_HPP__
+
+#include <ros/ros.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <map>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Snapshots of parameter namespaces, each fetched from the parameter server in one call; typically the private
+   * namespace of a nodelet, taken while it initializes (Oem7ParamSnapshot), and the tables consulted at runtime,
+   * kept for the lifetime of the nodelet (Oem7RuntimeParamSnapshot).
+   *
+   * Parameters found in a snapshot are served locally. Any other parameter, including one set on the parameter server
+   * after the snapshot was taken, is obtained from the parameter server as usual.
+   * Parameters set through the cache are written through to the parameter server.
+   *
+   * Thread safe.
+   */
+  class Oem7ParamCache
+  {
+    typedef std::map<std::string, XmlRpc::XmlRpcValue> SnapshotMap;
+
+    std::mutex  mtx_;
+    SnapshotMap snapshots_; ///< Namespace contents, by resolved namespace
+    std::map<std::string, int> refs_; ///< Holders of each snapshot, by resolved namespace
+
+    Oem7ParamCache()
+    {
+    }
+
+    /**
+     * @return true if a resolved parameter name is within a resolved namespace.
+     */
+    static bool isWithin(const std::string& name, const std::string& ns);
+
+    /**
+     * @return the snapshot value of a resolved parameter name; NULL if not in any snapshot. mtx_ held.
+     */
+    XmlRpc::XmlRpcValue* find(const std::string& name);
+
+    static bool convert(XmlRpc::XmlRpcValue& xml, XmlRpc::XmlRpcValue& value);
+    static bool convert(XmlRpc::XmlRpcValue& xml, std::string& value);
+    static bool convert(XmlRpc::XmlRpcValue& xml, int& value);
+    static bool convert(XmlRpc::XmlRpcValue& xml, double& value);
+    static bool convert(XmlRpc::XmlRpcValue& xml, bool& value);
+
+    template <typename T>
+    static bool convert(XmlRpc::XmlRpcValue& xml, std::vector<T>& value)
+    {
+      if(xml.getType() != XmlRpc::XmlRpcValue::TypeArray)
+        return false;
+
+      std::vector<T> vec(xml.size());
+      for(int i = 0; i < xml.size(); i++)
+      {
+        if(!convert(xml[i], vec[i]))
+          return false;
+      }
+
+      value.swap(vec);
+      return true;
+    }
+
+    template <typename T>
+    static bool convert(XmlRpc::XmlRpcValue& xml, std::map<std::string, T>& value)
+    {
+      if(xml.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+        return false;
+
+      std::map<std::string, T> map;
+      for(XmlRpc::XmlRpcValue::iterator itr = xml.begin(); itr != xml.end(); ++itr)
+      {
+        if(!convert(itr->second, map[itr->first]))
+          return false;
+      }
+
+      value.swap(map);
+      return true;
+    }
+
+  public:
+    static Oem7ParamCache& instance()
+    {
+      static Oem7ParamCache cache;
+      return cache;
+    }
+
+    /**
+     * Takes a snapshot of a namespace, replacing the contents of any earlier snapshot of it; each successful load
+     * is matched by a release().
+     * @return false if the namespace could not be obtained; the cache is unchanged then.
+     */
+    bool load(const std::string& ns);
+
+    /**
+     * Releases a load of a namespace. Once all are released, the snapshot is dropped, and its parameters are obtained
+     * from the parameter server.
+     */
+    void release(const std::string& ns);
+
+    /**
+     * As ros::NodeHandle::getParam.
+     */
+    template <typename T>
+    bool getParam(const ros::NodeHandle& nh, const std::string& name, T& value)
+    {
+      const std::string resolved = nh.resolveName(name);
+      {
+        std::lock_guard<std::mutex> lk(mtx_);
+        XmlRpc::XmlRpcValue* xml = find(resolved);
+        if(xml)
+        {
+          return convert(*xml, value);
+        }
+      }
+
+      return nh.getParam(name, value);
+    }
+
+    /**
+     * As ros::NodeHandle::hasParam.
+     */
+    bool hasParam(const ros::NodeHandle& nh, const std::string& name);
+
+    /**
+     * As ros::NodeHandle::setParam.
+     */
+    void setParam(const ros::NodeHandle& nh, const std::string& name, const std::string& value);
+  };
+
+  /**
+   * Keeps a snapshot of a namespace in Oem7ParamCache for the lifetime of the object.
+   */
+  class Oem7ParamSnapshot
+  {
+    const std::string ns_;
+    const bool        loaded_;
+
+  public:
+    explicit Oem7ParamSnapshot(const std::string& ns):
+      ns_(ns),
+      loaded_(Oem7ParamCache::instance().load(ns))
+    {
+    }
+
+    ~Oem7ParamSnapshot()
+    {
+      if(loaded_)
+      {
+        Oem7ParamCache::instance().release(ns_);
+      }
+    }
+
+    bool isLoaded() const
+    {
+      return loaded_;
+    }
+  };
+
+  /**
+   * Keeps snapshots of the node namespace tables consulted after startup, 'supported_imus' (on IMU type changes) and
+   * 'oem7_msgs', for the lifetime of the object.
+   */
+  class Oem7RuntimeParamSnapshot
+  {
+    const Oem7ParamSnapshot supported_imus_;
+    const Oem7ParamSnapshot oem7_msgs_;
+
+  public:
+    Oem7RuntimeParamSnapshot():
+      supported_imus_(ros::this_node::getNamespace() + "/supported_imus"),
+      oem7_msgs_     (ros::this_node::getNamespace() + "/oem7_msgs")
+    {
+      if(!supported_imus_.isLoaded())
+      {
+        ROS_WARN_STREAM("'" << ros::this_node::getNamespace() << "/supported_imus' not cached.");
+      }
+    }
+  };
+
+  /**
+   * Gets a parameter, from the parameter cache if possible; see Oem7ParamCache.
+   */
+  template <typename T>
+  bool getOem7Param(const ros::NodeHandle& nh, const std::string& name, T& value)
+  {
+    return Oem7ParamCache::instance().getParam(nh, name, value);
+  }
+}
+
+#endif
@@ -0,0 +1,594 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_PIPELINE_HPP__
+#define __OEM7_PIPELINE_HPP__
+
+#include <ros/ros.h>
+
+#include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <oem7_latency.hpp>
+
+#include "oem7_raw_message_if.hpp"
+using novatel_oem7::Oem7RawMessageIf;
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+
+#include <boost/shared_ptr.hpp>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Bounded, lock-free, single producer / single consumer queue.
+ * Capacity is rounded up to a power of 2.
+ */
+template <typename T>
+class Oem7SpscRing
+{
+  std::vector<T> slots_;
+  const size_t   mask_;
+
+  // Producer and consumer indices are kept on separate cache lines, to avoid false sharing.
+  char                pad0_[64];
+  std::atomic<size_t> head_; ///< Next slot to pop; written by consumer only.
+  char                pad1_[64];
+  std::atomic<size_t> tail_; ///< Next slot to push; written by producer only.
+  char                pad2_[64];
+
+  static size_t roundUpPow2(size_t n)
+  {
+    size_t p = 2;
+    while(p < n)
+    {
+      p <<= 1;
+    }
+    return p;
+  }
+
+public:
+  explicit Oem7SpscRing(size_t capacity):
+    slots_(roundUpPow2(capacity)),
+    mask_(slots_.size() - 1),
+    head_(0),
+    tail_(0)
+  {
+  }
+
+  size_t capacity() const
+  {
+    return slots_.size();
+  }
+
+  /**
+   * @return true when empty; exact on the consumer side only.
+   */
+  bool empty() const
+  {
+    return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @return false when full; the item is not consumed.
+   */
+  bool tryPush(T& item)
+  {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if(tail - head_.load(std::memory_order_acquire) >= slots_.size())
+    {
+      return false;
+    }
+
+    std::swap(slots_[tail & mask_], item);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @return false when empty
+   */
+  bool tryPop(T& item)
+  {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if(head == tail_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    std::swap(item, slots_[head & mask_]);
+    slots_[head & mask_] = T(); // Release any resources held by the slot.
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+
+/**
+ * Per-stage counters. Written by the stage threads, read by anyone.
+ */
+struct Oem7PipelineStageStats
+{
+  std::atomic<uint64_t> items;       ///< Items passed to the next stage
+  std::atomic<uint64_t> full_waits;  ///< Producer waited for space: backpressure from the next stage.
+  std::atomic<uint64_t> empty_waits; ///< Consumer waited for input: stage starved.
+
+  Oem7PipelineStageStats():
+    items(0),
+    full_waits(0),
+    empty_waits(0)
+  {
+  }
+};
+
+/**
+ * Wakes a stage waiting for a queue to change state. The waiter spins briefly, to keep latency low under load;
+ * then blocks until the other stage notifies it.
+ */
+class Oem7PipelineEvent
+{
+  static const unsigned int NUM_SPINS = 64;
+
+  std::mutex                mtx_;
+  std::condition_variable   cond_;
+  std::atomic<unsigned int> num_waiters_; ///< Blocked, or about to block.
+
+public:
+  Oem7PipelineEvent():
+    num_waiters_(0)
+  {
+  }
+
+  /**
+   * Waits until 'ready' returns true, or 'cancelled' does.
+   *
+   * @return true if ready.
+   */
+  template <typename Ready, typename Cancelled>
+  bool wait(Ready ready, Cancelled cancelled)
+  {
+    for(unsigned int attempt = 0; attempt < NUM_SPINS; attempt++)
+    {
+      if(ready())
+        return true;
+
+      if(cancelled())
+        return false;
+
+      std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    num_waiters_++;
+    std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with notify(): either sees the other's update.
+
+    bool is_ready;
+    while(!(is_ready = ready()) && !cancelled())
+    {
+      cond_.wait_for(lk, std::chrono::milliseconds(100)); // Cancellation, e.g. ROS shutdown, is not notified.
+    }
+
+    num_waiters_--;
+    return is_ready;
+  }
+
+  /**
+   * Wakes the waiter, if blocked; call after changing the queue state.
+   */
+  void notify()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(num_waiters_.load(std::memory_order_relaxed) > 0)
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      cond_.notify_all();
+    }
+  }
+};
+
+
+/**
+ * Reader stage: reads receiver input on a dedicated thread, into a bounded queue of byte chunks.
+ * Decouples receiver I/O from decoding, so that slow decoding or message handling does not stall reading
+ * and overrun receiver output buffers.
+ *
+ * Implements Oem7ReceiverIf; the decoder reads the chunks through it.
+ * By default, read() blocks until input is available. With an input callback set, read() does not block,
+ * and the callback is made on the reader thread whenever new input is queued; the decoder can then be scheduled
+ * on demand, e.g. on a shared worker pool.
+ */
+class Oem7PipelinedReceiver: public Oem7ReceiverIf
+{
+  struct Chunk
+  {
+    std::vector<uint8_t> data;
+    size_t               len;     ///< Valid bytes in data; 0: end of input.
+    Oem7InputArrival     arrival; ///< Arrival time of the data.
+  };
+  typedef boost::shared_ptr<Chunk> ChunkPtr;
+
+  /**
+   * State shared with the reader thread. The thread holds on to it: the thread may outlive the
+   * Oem7PipelinedReceiver while blocked in the actual receiver's read(); see ~Oem7PipelinedReceiver.
+   */
+  struct Reader
+  {
+    boost::shared_ptr<Oem7ReceiverIf> recvr; ///< Actual receiver
+
+    Oem7SpscRing<ChunkPtr> filled; ///< Reader --> Decoder
+    Oem7SpscRing<ChunkPtr> free;   ///< Decoder --> Reader; recycled chunks.
+    Oem7PipelineEvent      filled_event;
+    Oem7PipelineEvent      free_event;
+
+    std::mutex            cb_mtx;   ///< Orders input_cb calls with 'stop'
+    std::function<void()> input_cb; ///< Called when input is queued
+    std::atomic<bool>     stop;     ///< Request reader to stop; no input_cb calls once set.
+
+    std::mutex              done_mtx;
+    std::condition_variable done_cond;
+    bool                    done; ///< Reader thread finished.
+
+    Oem7PipelineStageStats stats;
+
+    Reader(const boost::shared_ptr<Oem7ReceiverIf>& r, size_t num_chunks):
+      recvr(r),
+      filled(num_chunks),
+      free(num_chunks),
+      stop(false),
+      done(false)
+    {
+    }
+  };
+
+  boost::shared_ptr<Reader> reader_;
+  std::thread               reader_thread_;
+
+  ChunkPtr         cur_chunk_;     ///< Chunk being consumed by decoder
+  size_t           cur_chunk_pos_; ///< Consumption offset into cur_chunk_
+  Oem7InputArrival read_arrival_;  ///< Arrival of the input returned by the latest read()
+  bool             end_of_input_;  ///< No more input; seen by the decoder.
+  bool             non_blocking_;  ///< read() does not block; input callback set.
+
+
+  static void readerLoop(boost::shared_ptr<Reader> reader)
+  {
+    ChunkPtr chunk;
+    for(;;)
+    {
+      if(!chunk && !reader->free.tryPop(chunk))
+      {
+        reader->stats.full_waits++;
+        if(!reader->free_event.wait([&](){ return reader->free.tryPop(chunk); },
+                                    [&](){ return reader->stop || ros::isShuttingDown(); }))
+        {
+          break;
+        }
+      }
+
+      size_t len = 0;
+      bool ok = !reader->stop && reader->recvr->read(boost::asio::buffer(chunk->data), len);
+      if(ok && len == 0)
+      {
+        continue; // Nothing read; retry with the same chunk.
+      }
+
+      chunk->len             = ok ? len : 0; // Empty chunk signals end of input.
+      chunk->arrival.stamp   = ros::Time::now();
+      chunk->arrival.mono_ns = OEM7_LATENCY_NOW();
+
+      while(!reader->filled.tryPush(chunk)) // chunk is reset on success.
+      {
+        std::this_thread::yield(); // Not for long: there are never more chunks than slots.
+      }
+      reader->stats.items++;
+      reader->filled_event.notify();
+
+      {
+        std::lock_guard<std::mutex> lk(reader->cb_mtx);
+        if(reader->input_cb && !reader->stop)
+        {
+          reader->input_cb();
+        }
+      }
+
+      if(!ok)
+      {
+        break;
+      }
+    }
+
+    std::lock_guard<std::mutex> lk(reader->done_mtx);
+    reader->done = true;
+    reader->done_cond.notify_all();
+  }
+
+public:
+  Oem7PipelinedReceiver(
+      const boost::shared_ptr<Oem7ReceiverIf>& recvr, ///< Receiver providing the actual input
+      size_t num_chunks,                              ///< Number of chunks buffered between reader and decoder.
+      size_t chunk_size                               ///< Size of each chunk, bytes
+      ):
+    reader_(new Reader(recvr, num_chunks)),
+    cur_chunk_pos_(0),
+    end_of_input_(false),
+    non_blocking_(false)
+  {
+    for(size_t c = 0; c < reader_->free.capacity(); c++)
+    {
+      ChunkPtr chunk(new Chunk);
+      chunk->data.resize(chunk_size);
+      chunk->len = 0;
+      reader_->free.tryPush(chunk);
+    }
+  }
+
+  /**
+   * Stops the reader thread.
+   * The actual receiver's read() may block, e.g. on a silent connection without a read timeout: the reader thread
+   * is then left to exit once read() returns, and keeps the receiver until then. No callbacks are made after return.
+   */
+  ~Oem7PipelinedReceiver()
+  {
+    {
+      std::lock_guard<std::mutex> lk(reader_->cb_mtx);
+      reader_->stop = true;
+    }
+    reader_->free_event.notify();
+
+    if(!reader_thread_.joinable())
+    {
+      return;
+    }
+
+    bool done;
+    {
+      std::unique_lock<std::mutex> lk(reader_->done_mtx);
+      done = reader_->done_cond.wait_for(lk, std::chrono::seconds(1), [this](){ return reader_->done; });
+    }
+
+    if(done)
+    {
+      reader_thread_.join();
+    }
+    else
+    {
+      ROS_WARN("Reader stage: receiver read() blocks; reader thread left to exit when it returns.");
+      reader_thread_.detach();
+    }
+  }
+
+  /**
+   * Makes read() non-blocking, with cb called on new input. Must be set before initialize().
+   */
+  void setInputCallback(const std::function<void()>& cb)
+  {
+    reader_->input_cb = cb;
+    non_blocking_     = static_cast<bool>(cb);
+  }
+
+  /**
+   * @return true if input is available to read(); decoder side only.
+   */
+  bool hasInput() const
+  {
+    return cur_chunk_ || !reader_->filled.empty();
+  }
+
+  /**
+   * Starts the reader thread. The wrapped receiver must already be initialized.
+   */
+  virtual bool initialize(ros::NodeHandle&)
+  {
+    reader_thread_ = std::thread(&Oem7PipelinedReceiver::readerLoop, reader_);
+    return true;
+  }
+
+  /**
+   * Copies the next available input into the decoder's buffer.
+   * Blocks until input is available, unless an input callback is set; then returns no data.
+   */
+  virtual bool read(boost::asio::mutable_buffer buf, size_t& rlen)
+  {
+    if(end_of_input_)
+    {
+      return false;
+    }
+
+    if(!cur_chunk_ && !reader_->filled.tryPop(cur_chunk_))
+    {
+      if(non_blocking_)
+      {
+        rlen = 0;
+        return true;
+      }
+
+      reader_->stats.empty_waits++;
+      if(!reader_->filled_event.wait([this](){ return reader_->filled.tryPop(cur_chunk_); },
+                                     [](){ return ros::isShuttingDown(); }))
+      {
+        return false;
+      }
+    }
+
+    if(cur_chunk_pos_ == 0 && cur_chunk_->len == 0)
+    {
+      end_of_input_ = true;
+      return false;
+    }
+
+    read_arrival_ = cur_chunk_->arrival;
+
+    rlen = std::min(boost::asio::buffer_size(buf), cur_chunk_->len - cur_chunk_pos_);
+    memcpy(boost::asio::buffer_cast<void*>(buf), cur_chunk_->data.data() + cur_chunk_pos_, rlen);
+    cur_chunk_pos_ += rlen;
+
+    if(cur_chunk_pos_ == cur_chunk_->len)
+    {
+      reader_->free.tryPush(cur_chunk_); // Never fails: chunks are only ever in one queue.
+      reader_->free_event.notify();
+      cur_chunk_.reset();
+      cur_chunk_pos_ = 0;
+    }
+
+    return true;
+  }
+
+  virtual bool write(boost::asio::const_buffer buf)
+  {
+    return reader_->recvr->write(buf);
+  }
+
+  /**
+   * @return arrival of the input returned by the latest read(): when the reader thread read it.
+   */
+  virtual Oem7InputArrival getReadArrival() const
+  {
+    return read_arrival_;
+  }
+
+  const Oem7PipelineStageStats& getStats() const
+  {
+    return reader_->stats;
+  }
+};
+
+
+/**
+ * Handler stage: dispatches decoded messages for handling on a dedicated worker thread,
+ * so that message handling and publishing does not stall decoding.
+ */
+class Oem7HandlerStage
+{
+public:
+  typedef std::function<void(const Oem7RawMessageIf::ConstPtr&, const ros::Time&)> HandlerFn; ///< Message, arrival
+
+private:
+  HandlerFn handler_;
+
+  struct Item
+  {
+    Oem7RawMessageIf::ConstPtr raw_msg;
+    ros::Time                  stamp; ///< Arrival of raw_msg
+    OEM7_LATENCY_TRACE_FIELD(trace)
+  };
+
+  Oem7SpscRing<Item> queue_;          ///< Decoder --> Worker
+  Oem7PipelineEvent  queued_event_;   ///< Item queued, or done
+  Oem7PipelineEvent  dequeued_event_; ///< Space available
+
+  std::atomic<bool> done_; ///< No more input will be submitted.
+  std::thread       worker_thread_;
+
+  Oem7PipelineStageStats stats_;
+
+
+  void workerLoop()
+  {
+    for(;;)
+    {
+      Item item;
+      if(!queue_.tryPop(item))
+      {
+        stats_.empty_waits++;
+        if(!queued_event_.wait([&](){ return queue_.tryPop(item); },
+                               [this](){ return done_ || ros::isShuttingDown(); }) &&
+           !queue_.tryPop(item)) // Submitted before 'done'
+        {
+          return;
+        }
+      }
+      dequeued_event_.notify();
+
+      OEM7_LATENCY_RESTORE(item.trace);
+
+      handler_(item.raw_msg, item.stamp);
+      stats_.items++;
+    }
+  }
+
+public:
+  Oem7HandlerStage(const HandlerFn& handler, size_t queue_size):
+    handler_(handler),
+    queue_(queue_size),
+    done_(false)
+  {
+    worker_thread_ = std::thread(&Oem7HandlerStage::workerLoop, this);
+  }
+
+  ~Oem7HandlerStage()
+  {
+    finish();
+  }
+
+  /**
+   * Queues a message for handling; blocks while the queue is full.
+   */
+  void submit(Oem7RawMessageIf::ConstPtr raw_msg, const ros::Time& stamp)
+  {
+    Item item;
+    item.raw_msg = raw_msg;
+    item.stamp   = stamp;
+    OEM7_LATENCY_SAVE(item.trace);
+
+    if(!queue_.tryPush(item))
+    {
+      stats_.full_waits++;
+      if(!dequeued_event_.wait([&](){ return queue_.tryPush(item); },
+                               [](){ return ros::isShuttingDown(); }))
+      {
+        return;
+      }
+    }
+    queued_event_.notify();
+  }
+
+  /**
+   * Handles all outstanding messages, and stops the worker.
+   */
+  void finish()
+  {
+    done_ = true;
+    queued_event_.notify();
+    if(worker_thread_.joinable())
+    {
+      worker_thread_.join();
+    }
+  }
+
+  const Oem7PipelineStageStats& getStats() const
+  {
+    return stats_;
+  }
+};
+
+}
+#endif
@@ -23,6 +23,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <oem7_param_cache.hpp>
 
 #include <ros/ros.h>
 
@@ -113,7 +114,7 @@ namespace novatel_oem7_driver
     {
       nh_ = h;
 
-      this->nh_.getParam("oem7_max_io_errors", max_num_io_errors_);
+      getOem7Param(this->nh_, "oem7_max_io_errors", max_num_io_errors_);
 
       return true;
     }
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <oem7_receiver_async.hpp>
+
+#include <ros/ros.h>
+
+#include <boost/asio.hpp>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Asynchronous TCP / UDP implementation.
+   */
+  template <class T>
+  class Oem7AsyncReceiverNet: public Oem7AsyncReceiver<typename T::socket>
+  {
+    typedef boost::function<void(const boost::system::error_code&)> OpenHandler;
+
+    void onConnect(const boost::system::error_code& err, const OpenHandler& handler)
+    {
+      ROS_INFO_STREAM("Oem7AsyncNet socket open: '" << this->endpoint_.is_open() << "; OS error= " << err.value());
+
+      if(!err)
+      {
+        static const std::string CONN_PRIMER("\r\n");
+        boost::system::error_code write_err;
+        boost::asio::write(this->endpoint_, boost::asio::buffer(CONN_PRIMER), write_err);
+      }
+
+      handler(err);
+    }
+
+    virtual void endpoint_async_open(const OpenHandler& handler)
+    {
+      std::string recvr_ip_addr;
+      getOem7Param(this->nh_, "oem7_ip_addr", recvr_ip_addr);
+
+      int recvr_port;
+      getOem7Param(this->nh_, "oem7_port", recvr_port);
+
+      ROS_INFO_STREAM("Oem7AsyncNet " << (T::v4().protocol() == IPPROTO_TCP ? "TCP" : "UDP") <<
+                      "['" << recvr_ip_addr << "' : " << recvr_port << "]");
+
+      boost::system::error_code err;
+      const boost::asio::ip::address addr = boost::asio::ip::address::from_string(recvr_ip_addr, err);
+      if(err)
+      {
+        this->io_.post(boost::bind(handler, err));
+        return;
+      }
+
+      this->endpoint_.close(err); // Doesn't matter if we fail.
+      this->endpoint_.async_connect(typename T::endpoint(addr, recvr_port),
+                                    boost::bind(&Oem7AsyncReceiverNet::onConnect, this,
+                                                boost::asio::placeholders::error, handler));
+    }
+
+  public:
+    ~Oem7AsyncReceiverNet()
+    {
+      this->stop();
+    }
+  };
+
+  class Oem7ReceiverAsyncTcp: public Oem7AsyncReceiverNet<boost::asio::ip::tcp>{};
+  class Oem7ReceiverAsyncUdp: public Oem7AsyncReceiverNet<boost::asio::ip::udp>{};
+
+
+  /**
+   * Asynchronous serial port (tty) implementation.
+   */
+  class Oem7ReceiverAsyncPort: public Oem7AsyncReceiver<boost::asio::serial_port>
+  {
+    virtual void endpoint_async_open(const boost::function<void(const boost::system::error_code&)>& handler)
+    {
+      std::string recvr_tty_name;
+      getOem7Param(nh_, "oem7_tty_name", recvr_tty_name);
+
+      int baud_rate = 0; // Optional parameter
+      getOem7Param(nh_, "oem7_tty_baud", baud_rate);
+      ROS_INFO_STREAM("Oem7AsyncSerialPort['" << recvr_tty_name << "' : " << baud_rate << "]");
+
+      // Opening a tty does not block; complete it in place and report through the handler.
+      boost::system::error_code err;
+      endpoint_.close(err);
+      endpoint_.open(recvr_tty_name, err);
+      ROS_INFO_STREAM("Oem7AsyncSerialPort open: '" << endpoint_.is_open() << "; err: " << err);
+
+      if(!err && baud_rate > 0)
+      {
+        boost::asio::serial_port_base::baud_rate baud_option(baud_rate);
+        endpoint_.set_option(baud_option, err);
+        ROS_INFO_STREAM("Oem7AsyncSerialPort set_option baud_rate: '" << baud_option.value() << " : " << err);
+      }
+
+      io_.post(boost::bind(handler, err));
+    }
+
+  public:
+    ~Oem7ReceiverAsyncPort()
+    {
+      stop();
+    }
+  };
+}
+
+
+#include <pluginlib/class_list_macros.h>
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::Oem7ReceiverAsyncTcp,  novatel_oem7_driver::Oem7ReceiverIf)
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::Oem7ReceiverAsyncUdp,  novatel_oem7_driver::Oem7ReceiverIf)
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::Oem7ReceiverAsyncPort, novatel_oem7_driver::Oem7ReceiverIf)
@@ -0,0 +1,453 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_RECEIVER_ASYNC_HPP__
+#define __OEM7_RECEIVER_ASYNC_HPP__
+
+#include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <oem7_param_cache.hpp>
+
+#include <ros/ros.h>
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <vector>
+
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * boost::asio receiver driven by its own io_service thread.
+   *
+   * Reads are issued with async_read_some into one of two buffers while the decoder consumes the other one,
+   * so the endpoint is serviced while the previous data is being decoded.
+   * Failed reads are handled on the io thread: the endpoint is closed and reopened after an exponentially
+   * increasing delay, without blocking the decoder.
+   * Opening and reading have deadlines: a connection attempt is abandoned after 'oem7_connect_timeout', and an endpoint
+   * silent for 'oem7_read_timeout' is treated as failed. A configured receiver streams logs continuously, so silence
+   * means a dead connection, e.g. a half-open TCP connection after receiver power loss, which is not reported otherwise.
+   * Set 'oem7_read_timeout' to 0 for a receiver which is expected to be silent, e.g. one that is not logging anything.
+   *
+   * The io thread calls endpoint_async_open(); implementations must call stop() in their destructors, so that the thread
+   * is gone before their part of the object is.
+   */
+  template <typename T>
+  class Oem7AsyncReceiver: public Oem7ReceiverIf
+  {
+  protected:
+    boost::asio::io_service io_;
+
+    ros::NodeHandle nh_;
+
+    T endpoint_; ///<  boost::asio communication endoint; socket, serial port, etc.
+
+  private:
+    enum
+    {
+      DEFAULT_MAX_NUM_IO_ERRORS = 7,
+      DEFAULT_READ_BUF_SIZE     = 16 * 1024,
+      NUM_READ_BUFS             = 2 ///< Double buffering: one being filled, one being consumed.
+    };
+
+    static constexpr double DEFAULT_RECONNECT_DELAY_MIN =  0.1; ///< [s]
+    static constexpr double DEFAULT_RECONNECT_DELAY_MAX = 10.0; ///< [s]
+    static constexpr double DEFAULT_CONNECT_TIMEOUT     =  5.0; ///< [s]; 0: no open deadline.
+    static constexpr double DEFAULT_READ_TIMEOUT        = 10.0; ///< [s]; 0: no read deadline.
+
+    /**
+     * Read buffer; owned by the io thread while a read into it is outstanding, by the consumer once filled.
+     */
+    struct ReadBuf
+    {
+      std::vector<uint8_t> data;
+      size_t len;    ///< Valid bytes
+      size_t offset; ///< Bytes already consumed
+      bool   filled;
+    };
+
+    boost::scoped_ptr<boost::asio::io_service::work> work_; ///< Keeps io thread running while idle.
+    boost::thread io_thread_;
+
+    boost::asio::deadline_timer reconnect_timer_;
+    boost::asio::deadline_timer open_timer_;
+    boost::asio::deadline_timer read_timer_;
+
+    ReadBuf read_bufs_[NUM_READ_BUFS];
+    size_t  fill_idx_;    ///< Next buffer to fill; io thread.
+    size_t  consume_idx_; ///< Next buffer to consume; consumer thread.
+    bool    read_pending_; ///< async_read_some outstanding; io thread.
+    bool    open_pending_; ///< endpoint_async_open outstanding; io thread.
+    std::atomic<bool> connected_; ///< Set on the io thread.
+    bool    failed_;       ///< Max errors exceeded; no further attempts are made.
+
+    std::mutex              mtx_; ///< Protects read_bufs_ state and failed_
+    std::condition_variable cv_;
+
+    double reconnect_delay_min_;
+    double reconnect_delay_max_;
+    double connect_timeout_;
+    double read_timeout_;
+
+    int max_num_io_errors_; ///< Number of consecutive io errors before declaring failure and quitting.
+    int num_io_errors_;     ///< Number of consecutive io errors; io thread.
+
+
+    /**
+     * Opens the endpoint; io thread.
+     */
+    void open()
+    {
+      open_pending_ = true;
+      if(connect_timeout_ > 0.0)
+      {
+        open_timer_.expires_from_now(boost::posix_time::microseconds(static_cast<int64_t>(connect_timeout_ * 1e6)));
+        open_timer_.async_wait(boost::bind(&Oem7AsyncReceiver::onOpenTimeout, this, boost::asio::placeholders::error));
+      }
+
+      endpoint_async_open(boost::bind(&Oem7AsyncReceiver::onOpen, this, boost::asio::placeholders::error));
+    }
+
+    void onOpenTimeout(const boost::system::error_code& err)
+    {
+      if(err == boost::asio::error::operation_aborted || !open_pending_)
+        return;
+
+      ROS_ERROR_STREAM("Oem7AsyncReceiver: not open in " << connect_timeout_ << " s.");
+      boost::system::error_code close_err;
+      endpoint_.close(close_err); // Aborts the outstanding open, which reports the error.
+    }
+
+    void onOpen(boost::system::error_code err)
+    {
+      open_pending_ = false;
+      open_timer_.cancel();
+
+      if(!err && !endpoint_.is_open()) // Opened, but closed by the deadline meanwhile.
+      {
+        err = boost::asio::error::timed_out;
+      }
+
+      if(err)
+      {
+        ROS_ERROR_STREAM("Oem7AsyncReceiver: open error: " << err.message());
+        onError();
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lk(mtx_);
+        connected_ = true;
+      }
+      cv_.notify_all();
+
+      startRead();
+    }
+
+    /**
+     * Issues the next read if a free buffer is available; io thread.
+     */
+    void startRead()
+    {
+      if(!connected_ || read_pending_)
+        return;
+
+      ReadBuf* rb = &read_bufs_[fill_idx_];
+      {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if(rb->filled)
+          return; // Consumer still owns it; restarted from release().
+      }
+
+      read_pending_ = true;
+      endpoint_.async_read_some(boost::asio::buffer(rb->data),
+                                boost::bind(&Oem7AsyncReceiver::onRead, this,
+                                            boost::asio::placeholders::error,
+                                            boost::asio::placeholders::bytes_transferred));
+      if(read_timeout_ > 0.0)
+      {
+        read_timer_.expires_from_now(boost::posix_time::microseconds(static_cast<int64_t>(read_timeout_ * 1e6)));
+        read_timer_.async_wait(boost::bind(&Oem7AsyncReceiver::onReadTimeout, this, boost::asio::placeholders::error));
+      }
+    }
+
+    void onRead(const boost::system::error_code& err, size_t len)
+    {
+      read_pending_ = false;
+      read_timer_.cancel();
+
+      if(err)
+      {
+        if(err != boost::asio::error::operation_aborted || connected_)
+        {
+          ROS_ERROR_STREAM("Oem7AsyncReceiver: read error: " << err.message());
+        }
+        onError();
+        return;
+      }
+
+      num_io_errors_ = 0;
+
+      if(len > 0)
+      {
+        {
+          std::lock_guard<std::mutex> lk(mtx_);
+          ReadBuf& rb = read_bufs_[fill_idx_];
+          rb.len    = len;
+          rb.offset = 0;
+          rb.filled = true;
+        }
+        cv_.notify_one();
+
+        fill_idx_ = (fill_idx_ + 1) % NUM_READ_BUFS;
+      }
+
+      startRead();
+    }
+
+    void onReadTimeout(const boost::system::error_code& err)
+    {
+      if(err == boost::asio::error::operation_aborted || !read_pending_)
+        return;
+
+      ROS_ERROR_STREAM("Oem7AsyncReceiver: no data in " << read_timeout_ << " s; reconnecting.");
+      connected_ = false;
+      boost::system::error_code close_err;
+      endpoint_.close(close_err); // Aborts outstanding read, which reports the error.
+    }
+
+    /**
+     * Closes the endpoint and schedules a reconnect with exponential backoff; io thread.
+     */
+    void onError()
+    {
+      connected_ = false;
+      boost::system::error_code err;
+      endpoint_.close(err);
+
+      num_io_errors_++;
+      if(num_io_errors_ >= max_num_io_errors_)
+      {
+        ROS_ERROR_STREAM("Oem7AsyncReceiver: Max Num IO errors exceeded: " << max_num_io_errors_);
+        {
+          std::lock_guard<std::mutex> lk(mtx_);
+          failed_ = true;
+        }
+        cv_.notify_all();
+        return;
+      }
+
+      const double delay = std::min(reconnect_delay_min_ * (1 << std::min(num_io_errors_ - 1, 20)),
+                                    reconnect_delay_max_);
+      ROS_ERROR_STREAM("Oem7AsyncReceiver: errors/max: " << num_io_errors_ << "/" << max_num_io_errors_
+                                                          << "; reconnecting in " << delay << " s");
+
+      reconnect_timer_.expires_from_now(boost::posix_time::microseconds(static_cast<int64_t>(delay * 1e6)));
+      reconnect_timer_.async_wait(boost::bind(&Oem7AsyncReceiver::onReconnectTimer, this, boost::asio::placeholders::error));
+    }
+
+    void onReconnectTimer(const boost::system::error_code& err)
+    {
+      if(err == boost::asio::error::operation_aborted)
+        return;
+
+      open();
+    }
+
+    void ioLoop()
+    {
+      boost::system::error_code err;
+      io_.run(err);
+    }
+
+  protected:
+    /**
+     * Asynchronously opens the endpoint; called on the io thread.
+     * Implementations must eventually invoke 'handler', on the io thread.
+     */
+    virtual void endpoint_async_open(const boost::function<void(const boost::system::error_code&)>& handler) = 0;
+
+    /**
+     * Stops and joins the io thread; pending handlers are not run. Idempotent; not to be called on the io thread.
+     */
+    void stop()
+    {
+      work_.reset();
+      io_.stop();
+      if(io_thread_.joinable())
+      {
+        io_thread_.join();
+      }
+    }
+
+  public:
+    Oem7AsyncReceiver():
+      io_(),
+      endpoint_(io_),
+      reconnect_timer_(io_),
+      open_timer_(io_),
+      read_timer_(io_),
+      fill_idx_(0),
+      consume_idx_(0),
+      read_pending_(false),
+      open_pending_(false),
+      connected_(false),
+      failed_(false),
+      reconnect_delay_min_(DEFAULT_RECONNECT_DELAY_MIN),
+      reconnect_delay_max_(DEFAULT_RECONNECT_DELAY_MAX),
+      connect_timeout_(DEFAULT_CONNECT_TIMEOUT),
+      read_timeout_(DEFAULT_READ_TIMEOUT),
+      max_num_io_errors_(DEFAULT_MAX_NUM_IO_ERRORS),
+      num_io_errors_(0)
+    {
+    }
+
+    virtual ~Oem7AsyncReceiver()
+    {
+      assert(!io_thread_.joinable()); // Stopped by the implementation; see stop().
+    }
+
+    virtual bool initialize(ros::NodeHandle& h)
+    {
+      nh_ = h;
+
+      getOem7Param(nh_, "oem7_max_io_errors", max_num_io_errors_);
+      getOem7Param(nh_, "oem7_reconnect_delay_min", reconnect_delay_min_);
+      getOem7Param(nh_, "oem7_reconnect_delay_max", reconnect_delay_max_);
+      getOem7Param(nh_, "oem7_connect_timeout",     connect_timeout_);
+      getOem7Param(nh_, "oem7_read_timeout",        read_timeout_);
+
+      int buf_size = DEFAULT_READ_BUF_SIZE;
+      getOem7Param(nh_, "oem7_read_buffer_size", buf_size);
+      if(buf_size <= 0)
+      {
+        buf_size = DEFAULT_READ_BUF_SIZE;
+      }
+
+      for(int i = 0; i < NUM_READ_BUFS; i++)
+      {
+        read_bufs_[i].data.resize(buf_size);
+        read_bufs_[i].len    = 0;
+        read_bufs_[i].offset = 0;
+        read_bufs_[i].filled = false;
+      }
+
+      ROS_INFO_STREAM("Oem7AsyncReceiver: buffers: " << NUM_READ_BUFS << " x " << buf_size
+                       << "; reconnect delay [" << reconnect_delay_min_ << ", " << reconnect_delay_max_ << "] s"
+                       << "; connect timeout " << connect_timeout_ << " s"
+                       << "; read timeout " << read_timeout_ << " s");
+
+      work_.reset(new boost::asio::io_service::work(io_));
+      io_.post(boost::bind(&Oem7AsyncReceiver::open, this));
+      io_thread_ = boost::thread(boost::bind(&Oem7AsyncReceiver::ioLoop, this));
+
+      return true;
+    }
+
+    virtual bool read(boost::asio::mutable_buffer buf, size_t& rlen)
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+
+      ReadBuf& rb = read_bufs_[consume_idx_];
+      while(!rb.filled)
+      {
+        if(failed_ || ros::isShuttingDown())
+          return false;
+
+        cv_.wait_for(lk, std::chrono::milliseconds(100));
+      }
+
+      rlen = std::min(boost::asio::buffer_size(buf), rb.len - rb.offset);
+      memcpy(boost::asio::buffer_cast<uint8_t*>(buf), &rb.data[rb.offset], rlen);
+      rb.offset += rlen;
+
+      if(rb.offset == rb.len) // Consumed; hand the buffer back to the io thread.
+      {
+        rb.filled = false;
+        consume_idx_ = (consume_idx_ + 1) % NUM_READ_BUFS;
+
+        lk.unlock();
+        io_.post(boost::bind(&Oem7AsyncReceiver::startRead, this));
+      }
+
+      return true;
+    }
+
+    /**
+     * Writes on the io thread, so that the endpoint is never accessed concurrently.
+     * Waits for the endpoint to connect, and for the write to complete.
+     */
+    virtual bool write(boost::asio::const_buffer buf)
+    {
+      {
+        std::unique_lock<std::mutex> lk(mtx_);
+        while(!connected_)
+        {
+          if(failed_ || ros::isShuttingDown())
+            return false;
+
+          cv_.wait_for(lk, std::chrono::milliseconds(100));
+        }
+      }
+
+      std::promise<boost::system::error_code> result;
+      std::future<boost::system::error_code> result_future = result.get_future();
+
+      io_.post([this, buf, &result]()
+      {
+        if(!connected_)
+        {
+          result.set_value(boost::asio::error::not_connected);
+          return;
+        }
+
+        boost::system::error_code err;
+        boost::asio::write(endpoint_, boost::asio::buffer(buf), err);
+        result.set_value(err);
+      });
+
+      const boost::system::error_code err = result_future.get();
+      if(err)
+      {
+        ROS_ERROR_STREAM("Oem7AsyncReceiver: write error: " << err.message());
+        return false;
+      }
+
+      return true;
+    }
+  };
+}
+
+#endif
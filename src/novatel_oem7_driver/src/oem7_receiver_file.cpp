@@ -23,15 +23,47 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <oem7_param_cache.hpp>
 
 #include <ros/ros.h>
 
 #include <boost/asio.hpp>
 #include <fstream>
+#include <algorithm>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 namespace novatel_oem7_driver
 {
+  const double DEFAULT_FILE_START_DELAY_SEC = 3.0; ///< Delay before the first read; see getFileStartDelay.
+
+  /**
+   * Obtains the delay applied before the first read from a file.
+   *
+   * Workaround for automated testing:
+   * delay reporting logs so that 'rosbag record' has a chance to subscribe to the topic after they are published.
+   * Otherwise it is likely to miss messages. Batch replays may set 'oem7_file_start_delay' to 0.
+   *
+   * @return delay, in seconds
+   */
+  double getFileStartDelay(ros::NodeHandle& nh)
+  {
+    double start_delay_sec = DEFAULT_FILE_START_DELAY_SEC;
+    getOem7Param(nh, "oem7_file_start_delay", start_delay_sec);
+    if(start_delay_sec < 0.0)
+    {
+      start_delay_sec = 0.0;
+    }
+
+    return start_delay_sec;
+  }
+
+
   /**
    * 'Virtual' Oem7 interface, where input is read from a file. The contents of the file is any relevant receiver output.
    */
@@ -41,10 +73,15 @@ namespace novatel_oem7_driver
 
     size_t num_byte_read_; ///< Total number of bytes read from file.
 
+    double start_delay_sec_; ///< Delay before the first read.
+    bool   start_delayed_;   ///< Start delay applied; only once, however the first read turns out.
+
 
   public:
     Oem7ReceiverFile():
-      num_byte_read_(0)
+      num_byte_read_(0),
+      start_delay_sec_(DEFAULT_FILE_START_DELAY_SEC),
+      start_delayed_(false)
     {
     }
 
@@ -58,9 +95,11 @@ namespace novatel_oem7_driver
     virtual bool initialize(ros::NodeHandle& nh)
     {
       std::string oem7_file_name;;
-      nh.getParam("oem7_file_name", oem7_file_name);
+      getOem7Param(nh, "oem7_file_name", oem7_file_name);
 
-      ROS_INFO_STREAM("Oem7File['" << oem7_file_name << "']");
+      start_delay_sec_ = getFileStartDelay(nh);
+
+      ROS_INFO_STREAM("Oem7File['" << oem7_file_name << "']; start delay: " << start_delay_sec_ << " s");
 
       oem7_file_.open(oem7_file_name, std::ios::in | std::ios::binary);
       int errno_value = errno; // Cache errno locally, in case any ROS calls /macros affect it.
@@ -86,12 +125,13 @@ namespace novatel_oem7_driver
         return false;
       }
 
-      // Workaround for automated testing:
-      // delay reporting logs so that 'rosbag record' has a chance to subscribe to the topic after they are published.
-      // Otherwise it is likely to miss messages.
-      if(num_byte_read_ == 0)
+      if(!start_delayed_)
       {
-        sleep(3); // Use absolute sleep, as this is not related to ROS internal timing.
+        start_delayed_ = true;
+        if(start_delay_sec_ > 0.0)
+        {
+          ros::WallDuration(start_delay_sec_).sleep(); // Use absolute sleep, as this is not related to ROS internal timing.
+        }
       }
 
       oem7_file_.read(boost::asio::buffer_cast<char*>(buf), boost::asio::buffer_size(buf));
@@ -127,7 +167,174 @@ namespace novatel_oem7_driver
       return false;
     }
   };
+
+
+  /**
+   * 'Virtual' Oem7 interface, where input is read from a memory-mapped file.
+   * Intended for replaying large captures: input is copied directly from the page cache into the decoder's buffer,
+   * without intermediate stream buffering. Kernel readahead is requested for sequential access, and pages
+   * already consumed are released, so that resident memory does not grow with the size of the file.
+   */
+  class Oem7ReceiverMmapFile: public Oem7ReceiverIf
+  {
+    static const size_t RELEASE_CHUNK_SIZE = 64 * 1024 * 1024; ///< Consumed pages are released in chunks of this size.
+
+    int fd_; ///< File descriptor of the mapped file
+
+    const uint8_t* data_; ///< Start of mapping
+    size_t         size_; ///< Size of mapping, bytes
+
+    size_t num_byte_read_; ///< Total number of bytes read from file; the current read position.
+    size_t num_byte_released_; ///< Number of bytes released back to the kernel.
+
+    double start_delay_sec_; ///< Delay before the first read.
+    bool   start_delayed_;   ///< Start delay applied; only once, however the first read turns out.
+
+
+    void unmap()
+    {
+      if(data_)
+      {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = NULL;
+      }
+
+      if(fd_ >= 0)
+      {
+        close(fd_);
+        fd_ = -1;
+      }
+    }
+
+    /**
+     * Releases the pages which have already been consumed; they are not going to be accessed again.
+     */
+    void releaseConsumedPages()
+    {
+      static const size_t page_size = sysconf(_SC_PAGESIZE);
+
+      if(num_byte_read_ - num_byte_released_ < RELEASE_CHUNK_SIZE)
+      {
+        return;
+      }
+
+      const size_t release_end = (num_byte_read_ / page_size) * page_size;
+      madvise(const_cast<uint8_t*>(data_) + num_byte_released_, release_end - num_byte_released_, MADV_DONTNEED);
+      num_byte_released_ = release_end;
+    }
+
+  public:
+    Oem7ReceiverMmapFile():
+      fd_(-1),
+      data_(NULL),
+      size_(0),
+      num_byte_read_(0),
+      num_byte_released_(0),
+      start_delay_sec_(DEFAULT_FILE_START_DELAY_SEC),
+      start_delayed_(false)
+    {
+    }
+
+    ~Oem7ReceiverMmapFile()
+    {
+      unmap();
+    }
+
+    /**
+     * Maps the input file into memory, read only.
+     */
+    virtual bool initialize(ros::NodeHandle& nh)
+    {
+      std::string oem7_file_name;
+      getOem7Param(nh, "oem7_file_name", oem7_file_name);
+
+      start_delay_sec_ = getFileStartDelay(nh);
+
+      ROS_INFO_STREAM("Oem7MmapFile['" << oem7_file_name << "']; start delay: " << start_delay_sec_ << " s");
+
+      fd_ = open(oem7_file_name.c_str(), O_RDONLY);
+      int errno_value = errno; // Cache errno locally, in case any ROS calls /macros affect it.
+      if(fd_ < 0)
+      {
+        ROS_ERROR_STREAM("Could not open '" << oem7_file_name << "'; error= " << errno_value << " '"
+                                            << strerror(errno_value) << "'");
+        return false;
+      }
+
+      struct stat file_stat;
+      if(fstat(fd_, &file_stat) != 0)
+      {
+        errno_value = errno;
+        ROS_ERROR_STREAM("Could not stat '" << oem7_file_name << "'; error= " << errno_value << " '"
+                                            << strerror(errno_value) << "'");
+        unmap();
+        return false;
+      }
+
+      size_ = file_stat.st_size;
+      if(size_ == 0)
+      {
+        ROS_WARN_STREAM("Oem7MmapFile['" << oem7_file_name << "'] is empty.");
+        return true;
+      }
+
+      void* mem = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+      errno_value = errno;
+      if(mem == MAP_FAILED)
+      {
+        ROS_ERROR_STREAM("Could not map '" << oem7_file_name << "'; error= " << errno_value << " '"
+                                           << strerror(errno_value) << "'");
+        unmap();
+        return false;
+      }
+
+      data_ = static_cast<const uint8_t*>(mem);
+      madvise(mem, size_, MADV_SEQUENTIAL); // Advisory only; failure is harmless.
+
+      return true;
+    }
+
+    /**
+     * Copies the next slice of the mapped file into the caller's buffer.
+     */
+    virtual bool read( boost::asio::mutable_buffer buf, size_t& rlen)
+    {
+      if(!start_delayed_)
+      {
+        start_delayed_ = true;
+        if(start_delay_sec_ > 0.0)
+        {
+          ros::WallDuration(start_delay_sec_).sleep(); // Use absolute sleep, as this is not related to ROS internal timing.
+        }
+      }
+
+      if(!data_ || num_byte_read_ >= size_)
+      {
+        ROS_INFO_STREAM("No more input available. Read " << num_byte_read_ << " bytes." );
+        return false;
+      }
+
+      rlen = std::min(boost::asio::buffer_size(buf), size_ - num_byte_read_);
+      memcpy(boost::asio::buffer_cast<void*>(buf), data_ + num_byte_read_, rlen);
+      num_byte_read_ += rlen;
+
+      releaseConsumedPages();
+
+      return true;
+    }
+
+    /**
+     * Takes no action.
+     *
+     * @return false always.
+     */
+    virtual bool write(boost::asio::const_buffer buf)
+    {
+      return false;
+    }
+  };
 }
 
 #include <pluginlib/class_list_macros.h>
-PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::Oem7ReceiverFile, novatel_oem7_driver::Oem7ReceiverIf)
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::Oem7ReceiverFile,     novatel_oem7_driver::Oem7ReceiverIf)
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::Oem7ReceiverMmapFile, novatel_oem7_driver::Oem7ReceiverIf)
@@ -46,10 +46,10 @@ namespace novatel_oem7_driver
 
 
       std::string recvr_ip_addr;
-      this->nh_.getParam("oem7_ip_addr", recvr_ip_addr);
+      getOem7Param(this->nh_, "oem7_ip_addr", recvr_ip_addr);
 
       int recvr_port;
-      this->nh_.getParam("oem7_port", recvr_port);
+      getOem7Param(this->nh_, "oem7_port", recvr_port);
 
       ROS_INFO_STREAM("Oem7Net " << (T::v4().protocol() == IPPROTO_TCP ? "TCP" : "UDP") <<
                       "['" << recvr_ip_addr << "' : " << recvr_port << "]");
@@ -45,10 +45,10 @@ namespace novatel_oem7_driver
       }
 
       std::string recvr_tty_name;
-      nh_.getParam("oem7_tty_name", recvr_tty_name);
+      getOem7Param(nh_, "oem7_tty_name", recvr_tty_name);
 
       int baud_rate = 0; // Optional parameter
-      nh_.getParam("oem7_tty_baud", baud_rate);
+      getOem7Param(nh_, "oem7_tty_baud", baud_rate);
       ROS_INFO_STREAM("Oem7SerialPort['" << recvr_tty_name << "' : " << baud_rate << "]");
 
 
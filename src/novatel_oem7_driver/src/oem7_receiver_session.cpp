@@ -0,0 +1,606 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <oem7_receiver_session.hpp>
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+
+#include "novatel_oem7_msgs/Oem7RawMsg.h"
+#include <novatel_oem7_driver/oem7_raw_msg_shared.hpp>
+#include "diagnostic_msgs/DiagnosticArray.h"
+
+#include <novatel_oem7_driver/oem7_message_util.hpp>
+#include <oem7_latency.hpp>
+#include <oem7_message_context.hpp>
+
+
+namespace novatel_oem7_driver
+{
+  Oem7ReceiverSession::Oem7ReceiverSession(const std::string& name, ros::NodeHandle& nh):
+    name_(name),
+    nh_(nh),
+    publish_delay_sec_(0),
+    publish_unknown_oem7raw_(false),
+    raw_msg_zero_copy_(false),
+    max_msgs_per_slice_(64),
+    finished_(false)
+  {
+  }
+
+  Oem7ReceiverSession::~Oem7ReceiverSession()
+  {
+    // Stop input first: the reader thread may call into the session.
+    pipelined_recvr_.reset();
+    handler_stage_.reset();
+  }
+
+  void Oem7ReceiverSession::initialize(
+      Oem7ReceiverLoader&       recvr_loader,
+      Oem7MessageDecoderLoader& decoder_loader,
+      ros::CallbackQueue*       cmd_queue,
+      bool                      pooled)
+  {
+    getOem7Param(nh_, "oem7_publish_unknown_oem7raw", publish_unknown_oem7raw_);
+
+    double replay_speed = 0.0;
+    getOem7Param(nh_, "oem7_replay_speed", replay_speed);
+    replay_scheduler_.setSpeed(replay_speed);
+    if(replay_scheduler_.isEnabled())
+    {
+      ROS_WARN_STREAM(name_ << ": Replay speed: " << replay_speed << "x GPS time. Is this is a replay?");
+    }
+
+    getOem7Param(nh_, "oem7_publish_delay", publish_delay_sec_);
+    if(publish_delay_sec_ > 0 && replay_scheduler_.isEnabled())
+    {
+      // Replay is paced by GPS time; a fixed delay on top of that only caps throughput.
+      ROS_WARN_STREAM(name_ << ": Publish Delay: " << publish_delay_sec_ << " seconds ignored; replay is paced.");
+      publish_delay_sec_ = 0;
+    }
+    else if(publish_delay_sec_ > 0)
+    {
+      ROS_WARN_STREAM(name_ << ": Publish Delay: " << publish_delay_sec_ << " seconds. Is this is a test?");
+    }
+
+    std::string stamp_mode = "arrival";
+    double stamp_window = 60.0;
+    getOem7Param(nh_, "oem7_stamp_mode",   stamp_mode);
+    getOem7Param(nh_, "oem7_stamp_window", stamp_window);
+    if(!header_stamper_.initialize(stamp_mode, stamp_window))
+    {
+      ROS_ERROR_STREAM(name_ << ": Unknown stamp mode '" << stamp_mode << "'; messages are stamped on arrival.");
+    }
+    else if(header_stamper_.getMode() != Oem7HeaderStamper::STAMP_ARRIVAL)
+    {
+      ROS_INFO_STREAM(name_ << ": Stamp mode: " << stamp_mode << "; window: " << stamp_window << " s");
+    }
+
+    // Load plugins
+
+    // Message handlers load concurrently with the receiver and decoder; they are independent.
+    Oem7StartupTimer startup;
+    ros::WallDuration handlers_time;
+    std::future<void> handlers_loaded = std::async(std::launch::async,
+        [this, &handlers_time]()
+        {
+          const ros::WallTime start = ros::WallTime::now();
+          msg_handler_.reset(new MessageHandler(nh_));
+          handlers_time = ros::WallTime::now() - start;
+        });
+
+    // Load Oem7Receiver
+    std::string oem7_if_name;
+    getOem7Param(nh_, "oem7_if", oem7_if_name);
+    recvr_ = createOem7Plugin(recvr_loader, oem7_if_name);
+    recvr_->initialize(nh_);
+    startup.endPhase("receiver");
+
+    // Pooled decoding reads through the pipeline's reader stage, which never blocks the pool.
+    bool pipelined = pooled;
+    if(!pooled)
+    {
+      getOem7Param(nh_, "oem7_pipelined", pipelined);
+    }
+
+    int num_chunks = 64;
+    int chunk_size = 16 * 1024;
+
+    Oem7ReceiverIf* decoder_input = recvr_.get();
+    if(pipelined)
+    {
+      getOem7Param(nh_, "oem7_pipeline_read_chunks",     num_chunks);
+      getOem7Param(nh_, "oem7_pipeline_read_chunk_size", chunk_size);
+
+      pipelined_recvr_.reset(new Oem7PipelinedReceiver(recvr_, num_chunks, chunk_size));
+      if(!pooled)
+      {
+        pipelined_recvr_->initialize(nh_); // Pooled: started with the session.
+      }
+      decoder_input = pipelined_recvr_.get();
+    }
+
+    // Load Oem7 Message Decoder
+    std::string msg_decoder_name;
+    getOem7Param(nh_, "oem7_msg_decoder", msg_decoder_name);
+    msg_decoder_ = createOem7Plugin(decoder_loader, msg_decoder_name);
+    if(pooled && !msg_decoder_->supportsServiceAvailable())
+    {
+      throw std::runtime_error(name_ + ": decoder '" + msg_decoder_name + "' does not support pooled decoding");
+    }
+    msg_decoder_->initialize(nh_, decoder_input, this);
+    startup.endPhase("decoder");
+
+    handlers_loaded.get(); // Rethrows handler loading errors.
+    startup.endPhase("handlers wait");
+    ROS_INFO_STREAM(name_ << ": Startup: handlers: " << static_cast<int>(handlers_time.toSec() * 1000.0)
+                          << " ms, concurrently with: " << startup.getBreakdown());
+
+    if(pooled)
+    {
+      if(publish_delay_sec_ > 0 || replay_scheduler_.isEnabled())
+      {
+        ROS_WARN_STREAM(name_ << ": Publish delay and replay pacing block a shared decode thread.");
+      }
+
+      int max_msgs_per_slice = max_msgs_per_slice_;
+      getOem7Param(nh_, "oem7_decode_slice_msgs", max_msgs_per_slice);
+      max_msgs_per_slice_ = std::max(max_msgs_per_slice, 1);
+
+      ROS_INFO_STREAM(name_ << ": Pooled decoding: read chunks: " << num_chunks << " x " << chunk_size
+                            << " bytes; messages per slice: " << max_msgs_per_slice_);
+    }
+    else if(pipelined)
+    {
+      int queue_size = 1024;
+      getOem7Param(nh_, "oem7_pipeline_queue_size", queue_size);
+
+      handler_stage_.reset(new Oem7HandlerStage(
+                                  [this](const Oem7RawMessageIf::ConstPtr& raw_msg, const ros::Time& arrival)
+                                  {
+                                    handleLog(raw_msg, arrival);
+                                  },
+                                  queue_size));
+
+      ROS_INFO_STREAM(name_ << ": Pipelined: read chunks: " << num_chunks << " x " << chunk_size
+                            << " bytes; handler queue: " << queue_size);
+    }
+
+    // Oem7 raw messages to publish.
+    std::vector<std::string> oem7_raw_msgs;
+    getOem7Param(nh_, "oem7_raw_msgs", oem7_raw_msgs);
+    for(const auto& msg : oem7_raw_msgs)
+    {
+      int raw_msg_id = getOem7MessageId(msg);
+      if(raw_msg_id == 0)
+      {
+        ROS_ERROR_STREAM(name_ << ": Unknown Oem7 message '" << msg );
+      }
+      else
+      {
+        ROS_INFO_STREAM(name_ << ": Oem7 Raw message '" << msg << "' will be published." );
+        raw_msg_pub_.insert(raw_msg_id);
+      }
+    }
+
+    getOem7Param(nh_, "oem7_raw_msg_zero_copy", raw_msg_zero_copy_);
+    if(raw_msg_zero_copy_)
+    {
+      ROS_INFO_STREAM(name_ << ": Oem7RawMsg: zero-copy.");
+      oem7rawmsg_pub_.setup<Oem7RawMsgShared>("Oem7RawMsg", nh_);
+    }
+    else
+    {
+      oem7rawmsg_pub_.setup<novatel_oem7_msgs::Oem7RawMsg>("Oem7RawMsg", nh_);
+    }
+
+    log_stats_pub_.setup<diagnostic_msgs::DiagnosticArray>("LogStatisticsDiagnostics", nh_);
+    if(log_stats_pub_.isEnabled())
+    {
+      double log_stats_period = 1.0;
+      getOem7Param(nh_, "oem7_log_statistics_period", log_stats_period);
+      log_stats_timer_ = nh_.createTimer(ros::Duration(log_stats_period),
+                                         &Oem7ReceiverSession::publishLogStatisticsCb, this);
+    }
+
+    int    cmd_window   = 16;
+    double cmd_timeout  = 3.0;
+    int    cmd_attempts = 10;
+    getOem7Param(nh_, "oem7_cmd_window",   cmd_window);
+    getOem7Param(nh_, "oem7_cmd_timeout",  cmd_timeout);
+    getOem7Param(nh_, "oem7_cmd_attempts", cmd_attempts);
+    cmd_window = std::max(cmd_window, 1);
+    cmd_engine_.reset(new Oem7CommandEngine(name_,
+                                            boost::bind(&Oem7ReceiverSession::writeCommand, this, _1),
+                                            cmd_window,
+                                            cmd_timeout,
+                                            cmd_attempts));
+    ROS_INFO_STREAM(name_ << ": Commands: window: " << cmd_window << "; timeout: " << cmd_timeout
+                          << " s; attempts: " << cmd_attempts);
+
+    ros::AdvertiseServiceOptions ops = ros::AdvertiseServiceOptions::create<novatel_oem7_msgs::Oem7AbasciiCmd>(
+                                                          "Oem7Cmd",
+                                                          boost::bind(&Oem7ReceiverSession::serviceOem7AbasciiCb, this, _1, _2),
+                                                          ros::VoidConstPtr(),
+                                                          cmd_queue);
+    oem7_cmd_srv_ = nh_.advertiseService(ops);
+
+    ros::AdvertiseServiceOptions batch_ops = ros::AdvertiseServiceOptions::create<novatel_oem7_msgs::Oem7AbasciiCmdBatch>(
+                                                          "Oem7CmdBatch",
+                                                          boost::bind(&Oem7ReceiverSession::serviceOem7AbasciiBatchCb, this, _1, _2),
+                                                          ros::VoidConstPtr(),
+                                                          cmd_queue);
+    oem7_cmd_batch_srv_ = nh_.advertiseService(batch_ops);
+  }
+
+
+  void Oem7ReceiverSession::service()
+  {
+    msg_decoder_->service();
+
+    finish();
+  }
+
+  void Oem7ReceiverSession::start(boost::asio::io_service& workers, const std::function<void()>& on_finished)
+  {
+    assert(pipelined_recvr_);
+
+    on_finished_ = on_finished;
+    strand_.reset(new boost::asio::io_service::strand(workers));
+
+    // New input schedules a decoding slice; redundant slices find no input and return.
+    pipelined_recvr_->setInputCallback(
+        [this]()
+        {
+          strand_->post(boost::bind(&Oem7ReceiverSession::serviceSlice, this));
+        });
+    pipelined_recvr_->initialize(nh_);
+  }
+
+  /**
+   * Decodes and handles a bounded number of messages; runs on the session strand.
+   */
+  void Oem7ReceiverSession::serviceSlice()
+  {
+    if(finished_)
+    {
+      return;
+    }
+
+    if(!msg_decoder_->serviceAvailable(max_msgs_per_slice_))
+    {
+      finished_ = true;
+      finish();
+      on_finished_();
+      return;
+    }
+
+    if(pipelined_recvr_->hasInput())
+    {
+      // Yield the worker to other sessions; the rest of the input is decoded in the next slice.
+      strand_->post(boost::bind(&Oem7ReceiverSession::serviceSlice, this));
+    }
+  }
+
+  void Oem7ReceiverSession::finish()
+  {
+    if(handler_stage_)
+    {
+      handler_stage_->finish(); // Handle all outstanding messages.
+    }
+
+    outputLogStatistics();
+
+    ROS_WARN_STREAM(name_ << ": No more input from Decoder; receiver session finished.");
+  }
+
+
+  void Oem7ReceiverSession::writeCommand(const std::string& cmd)
+  {
+    const std::string line = cmd + "\n";
+    recvr_->write(boost::asio::buffer(line));
+  }
+
+  void Oem7ReceiverSession::logCommandResponse(const std::string& cmd, const std::string& rsp)
+  {
+    if(rsp == "OK")
+    {
+      ROS_INFO_STREAM(name_ << ": AACmd '" << cmd << "' : " << "'" << rsp << "'");
+    }
+    else
+    {
+      ROS_ERROR_STREAM(name_ << ": AACmd '" << cmd << "' : " << "'" << rsp << "'");
+    }
+  }
+
+  /**
+   * Called to request O7AbasciiCmd service
+   */
+  bool Oem7ReceiverSession::serviceOem7AbasciiCb(
+      novatel_oem7_msgs::Oem7AbasciiCmd::Request& req,
+      novatel_oem7_msgs::Oem7AbasciiCmd::Response& rsp)
+  {
+    ROS_DEBUG_STREAM(name_ << ": AACmd: cmd '" << req.cmd << "'");
+
+    rsp.rsp = cmd_engine_->execute(req.cmd);
+
+    logCommandResponse(req.cmd, rsp.rsp);
+
+    return true;
+  }
+
+  /**
+   * Called to request O7AbasciiCmdBatch service; the commands are pipelined.
+   */
+  bool Oem7ReceiverSession::serviceOem7AbasciiBatchCb(
+      novatel_oem7_msgs::Oem7AbasciiCmdBatch::Request& req,
+      novatel_oem7_msgs::Oem7AbasciiCmdBatch::Response& rsp)
+  {
+    ROS_DEBUG_STREAM(name_ << ": AACmd: batch of " << req.cmds.size());
+
+    cmd_engine_->execute(req.cmds, rsp.rsps);
+
+    for(size_t i = 0; i < req.cmds.size(); i++)
+    {
+      logCommandResponse(req.cmds[i], rsp.rsps[i]);
+    }
+
+    return true;
+  }
+
+  /**
+   * Outputs Log statistics to ROS console.
+   */
+  void Oem7ReceiverSession::outputLogStatistics()
+  {
+    ROS_INFO_STREAM(name_ << ": Log Statistics:");
+    ROS_INFO_STREAM(name_ << ": Logs: " << log_stats_.getTotal() << "; unknown: "   << log_stats_.getUnknown()
+                                                          << "; discarded: " << log_stats_.getDiscarded());
+
+    std::vector<int> ids;
+    log_stats_.getSeenIds(ids);
+    std::sort(ids.begin(), ids.end());
+    for(int id: ids)
+    {
+      ROS_INFO_STREAM(name_ << ": Log[" << getOem7MessageName(id) << "](" << id << "):" << log_stats_.getCounters(id).count);
+    }
+
+    if(pipelined_recvr_)
+    {
+      const Oem7PipelineStageStats& stats = pipelined_recvr_->getStats();
+      ROS_INFO_STREAM(name_ << ": Pipeline read stage: chunks: " << stats.items
+                                        << "; backpressure waits: " << stats.full_waits
+                                        << "; decoder starved: "    << stats.empty_waits);
+    }
+
+    if(handler_stage_)
+    {
+      const Oem7PipelineStageStats& stats = handler_stage_->getStats();
+      ROS_INFO_STREAM(name_ << ": Pipeline handler stage: messages: " << stats.items
+                                        << "; backpressure waits: " << stats.full_waits
+                                        << "; handler starved: "    << stats.empty_waits);
+    }
+  }
+
+  /**
+   * Publishes log statistics: totals, and per message ID rates, throughput and observed periods
+   * over the period since the previous call.
+   */
+  void Oem7ReceiverSession::publishLogStatisticsCb(const ros::TimerEvent&)
+  {
+    const ros::WallTime now = ros::WallTime::now();
+    const double period = log_stats_prev_time_.isZero() ? 0.0 : (now - log_stats_prev_time_).toSec();
+    log_stats_prev_time_ = now;
+
+    boost::shared_ptr<diagnostic_msgs::DiagnosticArray> diag(new diagnostic_msgs::DiagnosticArray);
+
+    diagnostic_msgs::DiagnosticStatus summary;
+    summary.level       = diagnostic_msgs::DiagnosticStatus::OK;
+    summary.name        = name_ + ": logs";
+    summary.message     = std::to_string(log_stats_.getTotal()) + " logs";
+    summary.values.resize(3);
+    summary.values[0].key = "total";     summary.values[0].value = std::to_string(log_stats_.getTotal());
+    summary.values[1].key = "unknown";   summary.values[1].value = std::to_string(log_stats_.getUnknown());
+    summary.values[2].key = "discarded"; summary.values[2].value = std::to_string(log_stats_.getDiscarded());
+    diag->status.push_back(summary);
+
+    std::vector<int> ids;
+    log_stats_.getSeenIds(ids);
+    for(int id: ids)
+    {
+      const Oem7LogStatistics::LogCounters& counters = log_stats_.getCounters(id);
+      const uint64_t count = counters.count;
+      const uint64_t bytes = counters.bytes;
+
+      LogStatisticsSnapshot& prev = log_stats_prev_[id]; // Zero-initialized when new.
+      const uint64_t new_count = count - prev.count;
+      const uint64_t new_bytes = bytes - prev.bytes;
+      prev.count = count;
+      prev.bytes = bytes;
+
+      const double max_period = log_stats_.takeMaxGap(id) / 1e9;
+
+      diagnostic_msgs::DiagnosticStatus status;
+      status.level       = diagnostic_msgs::DiagnosticStatus::OK;
+      status.name        = name_ + ": log: " + getOem7MessageName(id);
+      status.hardware_id = std::to_string(id);
+      status.message     = std::to_string(count) + " logs";
+      status.values.resize(5);
+      status.values[0].key = "count";               status.values[0].value = std::to_string(count);
+      status.values[1].key = "rate [Hz]";           status.values[1].value = std::to_string(period > 0.0 ? new_count / period : 0.0);
+      status.values[2].key = "throughput [B/s]";    status.values[2].value = std::to_string(period > 0.0 ? new_bytes / period : 0.0);
+      status.values[3].key = "mean period [s]";     status.values[3].value = std::to_string(new_count > 0 ? period / new_count : 0.0);
+      status.values[4].key = "max period [s]";      status.values[4].value = std::to_string(max_period);
+      diag->status.push_back(status);
+    }
+
+    log_stats_pub_.publish(diag);
+  }
+
+  void Oem7ReceiverSession::publishOem7RawMsg(Oem7RawMessageIf::ConstPtr raw_msg)
+  {
+      if(raw_msg_zero_copy_)
+      {
+        // Shares ownership of the raw message; the frame stays in the decoder's buffer.
+        Oem7RawMsgShared::Ptr oem7_raw_msg(new Oem7RawMsgShared);
+        oem7_raw_msg->message_data     = boost::shared_ptr<const uint8_t>(raw_msg, raw_msg->getMessageData(0));
+        oem7_raw_msg->message_data_len = raw_msg->getMessageDataLength();
+
+        oem7rawmsg_pub_.publish(oem7_raw_msg);
+        return;
+      }
+
+      novatel_oem7_msgs::Oem7RawMsg::Ptr oem7_raw_msg(new novatel_oem7_msgs::Oem7RawMsg);
+      oem7_raw_msg->message_data.insert(
+                                      oem7_raw_msg->message_data.end(),
+                                      raw_msg->getMessageData(0),
+                                      raw_msg->getMessageData(raw_msg->getMessageDataLength()));
+
+      assert(oem7_raw_msg->message_data.size() == raw_msg->getMessageDataLength());
+
+      oem7rawmsg_pub_.publish(oem7_raw_msg);
+  } 
+
+  /**
+   * Handles a log: dispatches it to message handlers, and publishes it as Oem7RawMsg if required.
+   * Called on the decoder thread, or on the handler stage thread in pipelined mode.
+   */
+  void Oem7ReceiverSession::handleLog(const Oem7RawMessageIf::ConstPtr& raw_msg, const ros::Time& arrival)
+  {
+    ros::Time stamp = arrival;
+    if(replay_scheduler_.isEnabled())
+    {
+      replay_scheduler_.pace(raw_msg);
+      stamp = ros::Time::now(); // Stamp replayed messages as released.
+    }
+
+    header_stamper_.stamp(raw_msg, stamp);
+
+    OEM7_LATENCY_HANDLER();
+
+    {
+      Oem7MessageScope scope(stamp);
+      msg_handler_->handleMessage(raw_msg);
+    }
+
+    // Publish Oem7RawMsg if specified
+    if(raw_msg_pub_.find(raw_msg->getMessageId()) != raw_msg_pub_.end())
+    {
+        publishOem7RawMsg(raw_msg);
+    }
+
+    if(publish_delay_sec_ > 0)
+    {
+      sleep(publish_delay_sec_);
+    }
+  }
+
+
+ /**
+   * Called by ROS decoder with new raw messages
+   */
+  void Oem7ReceiverSession::onNewMessage(Oem7RawMessageIf::ConstPtr raw_msg)
+  {
+    Oem7InputArrival arrival;
+    arrival.stamp = ros::Time::now(); // Decoder does not know better.
+    onNewStampedMessage(raw_msg, arrival);
+  }
+
+  void Oem7ReceiverSession::onNewStampedMessage(Oem7RawMessageIf::ConstPtr raw_msg, const Oem7InputArrival& arrival)
+  {
+    OEM7_LATENCY_DECODE(raw_msg->getMessageId(), arrival.mono_ns);
+
+    ROS_DEBUG_STREAM(name_ << ": onNewMsg: fmt= " << raw_msg->getMessageFormat()
+                            <<   " type= " << raw_msg->getMessageType());
+
+    // Discard all unknown messages; this is normally when dealing with responses to ASCII commands.
+    if(raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_UNKNOWN)
+    {
+      log_stats_.addUnknown();
+      ROS_DEBUG_STREAM(name_ << ": Unknown:    [ID: "   << raw_msg->getMessageId()          <<
+                                        "Type: " << raw_msg->getMessageType()        <<
+                                        "Fmt: "  << raw_msg->getMessageFormat()      <<
+                                        "Len: "  << raw_msg->getMessageDataLength()  <<
+                                        "]");
+      if(publish_unknown_oem7raw_)
+      {
+          publishOem7RawMsg(raw_msg);
+      }
+      else
+      {
+          log_stats_.addDiscarded();
+      }
+    }
+    else
+    {
+      if(raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_ASCII  ||
+         raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_ABASCII)
+      {
+        std::string msg(raw_msg->getMessageData(0), raw_msg->getMessageData(raw_msg->getMessageDataLength()));
+
+        ROS_DEBUG_STREAM(name_ << ": >---------------------------" << std::endl
+                          << msg                            << std::endl
+                          << "<---------------------------");
+      }
+
+      if(raw_msg->getMessageType() == Oem7RawMessageIf::OEM7MSGTYPE_RSP) // Response
+      {
+        std::string rsp(raw_msg->getMessageData(0), raw_msg->getMessageData(raw_msg->getMessageDataLength()));
+        if(rsp.find_first_not_of(" \t\r\n") == std::string::npos) // ignore all-whitespace responses
+        {
+          ROS_DEBUG_STREAM(name_ << ": Discarded empty ASCII response.");
+        }
+        else if(std::all_of(rsp.begin(), rsp.end(), [](char c){return std::isprint(c);}))
+        {
+          cmd_engine_->onResponse(rsp);
+        }
+        else // Corrupt; still a response, to the oldest outstanding command.
+        {
+          ROS_ERROR_STREAM(name_ << ": Discarded corrupt ASCII response: '" << rsp << "'");
+          cmd_engine_->onCorruptResponse();
+        }
+      }
+      else // Log
+      {
+        if( raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_BINARY  || // binary
+           (raw_msg->getMessageFormat() == Oem7RawMessageIf::OEM7MSGFMT_ASCII && isNMEAMessage(raw_msg)))
+        {
+          log_stats_.addLog(raw_msg->getMessageId(), raw_msg->getMessageDataLength());
+
+          if(handler_stage_)
+          {
+            handler_stage_->submit(raw_msg, arrival.stamp);
+          }
+          else
+          {
+            handleLog(raw_msg, arrival.stamp);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_RECEIVER_SESSION_HPP__
+#define __OEM7_RECEIVER_SESSION_HPP__
+
+#include <ros/ros.h>
+
+#include <atomic>
+#include <map>
+#include <set>
+
+#include <boost/asio.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "novatel_oem7_msgs/Oem7AbasciiCmd.h"
+#include "novatel_oem7_msgs/Oem7AbasciiCmdBatch.h"
+
+#include <pluginlib/class_loader.h>
+
+#include <novatel_oem7_driver/oem7_receiver_if.hpp>
+#include <novatel_oem7_driver/oem7_message_decoder_if.hpp>
+
+#include <oem7_ros_publisher.hpp>
+#include <oem7_replay_scheduler.hpp>
+#include <oem7_header_stamper.hpp>
+#include <oem7_pipeline.hpp>
+#include <oem7_log_statistics.hpp>
+#include <oem7_command_engine.hpp>
+#include <oem7_startup.hpp>
+
+#include <message_handler.hpp>
+
+
+namespace novatel_oem7_driver
+{
+  typedef pluginlib::ClassLoader<novatel_oem7_driver::Oem7ReceiverIf>        Oem7ReceiverLoader;
+  typedef pluginlib::ClassLoader<novatel_oem7_driver::Oem7MessageDecoderIf>  Oem7MessageDecoderLoader;
+
+  /**
+   * A single Oem7 receiver: its receiver and decoder plugins, message handlers, publishers and command service.
+   * All configuration is obtained from the session's NodeHandle namespace.
+   *
+   * Decoding runs either:
+   * - Standalone: service() blocks the calling thread, decoding until the input ends.
+   * - Pooled: start() reads the receiver on a dedicated thread, and schedules decoding and message handling
+   *   on a shared io_service, on demand and in bounded slices, so that a pool of workers is shared fairly
+   *   between receivers. The session's slices are serialized by its strand.
+   */
+  class Oem7ReceiverSession: public Oem7MessageDecoderUserIf
+  {
+    const std::string name_; ///< Session name, for diagnostics and log output.
+    ros::NodeHandle   nh_;   ///< Session configuration and publishing namespace.
+
+    double publish_delay_sec_; ///< Delay after publishing each message; used to throttle output with static data sources. 0 if replay is paced.
+    Oem7ReplayScheduler replay_scheduler_; ///< Paces output of recorded data sources based on message GPS time.
+    Oem7HeaderStamper header_stamper_; ///< Stamps messages from their GPS time, if configured.
+
+    Oem7RosPublisher oem7rawmsg_pub_; ///< Publishes raw Oem7 messages.
+    bool publish_unknown_oem7raw_; ///< Publish all unknown messages to 'Oem7Raw'
+
+    std::set<int> raw_msg_pub_; ///< Set of raw messages to publish.
+    bool raw_msg_zero_copy_; ///< Publish Oem7RawMsg sharing the decoder's buffer.
+
+    // Command service
+    boost::scoped_ptr<Oem7CommandEngine> cmd_engine_; ///< Issues commands; correlates responses.
+    ros::ServiceServer      oem7_cmd_srv_;       ///< Oem7 command service.
+    ros::ServiceServer      oem7_cmd_batch_srv_; ///< Oem7 command batch service.
+
+    boost::shared_ptr<MessageHandler> msg_handler_; ///< Dispatches individual messages for handling.
+
+    // Log statistics
+    Oem7LogStatistics log_stats_; ///< Updated by the decoder; read by diagnostics.
+
+    Oem7RosPublisher log_stats_pub_;   ///< Publishes log statistics diagnostics.
+    ros::Timer       log_stats_timer_; ///< Log statistics diagnostics period.
+
+    /**
+     * Log statistics at the previous diagnostics publication; used to derive rates.
+     */
+    struct LogStatisticsSnapshot
+    {
+      uint64_t count;
+      uint64_t bytes;
+    };
+    std::map<int, LogStatisticsSnapshot> log_stats_prev_;
+    ros::WallTime log_stats_prev_time_;
+
+    boost::shared_ptr<novatel_oem7_driver::Oem7MessageDecoderIf> msg_decoder_; ///< Message Decoder plugin
+    boost::shared_ptr<novatel_oem7_driver::Oem7ReceiverIf> recvr_; ///< Oem7 Receiver Interface plugin
+
+    // Pipelined mode: receiver input, decoding and message handling run on separate threads.
+    boost::shared_ptr<Oem7PipelinedReceiver> pipelined_recvr_; ///< Reader stage; decoder input.
+    boost::scoped_ptr<Oem7HandlerStage>      handler_stage_;   ///< Message handling stage.
+
+    // Pooled mode
+    boost::scoped_ptr<boost::asio::io_service::strand> strand_; ///< Serializes decoding slices.
+    size_t max_msgs_per_slice_;       ///< Messages decoded before yielding to other sessions.
+    std::atomic<bool> finished_;      ///< No more input.
+    std::function<void()> on_finished_; ///< Called once decoding finishes in pooled mode.
+
+
+    void initializeReceiver(bool pipelined);
+
+    void serviceSlice();
+
+    void finish();
+
+    bool serviceOem7AbasciiCb(novatel_oem7_msgs::Oem7AbasciiCmd::Request& req,
+                              novatel_oem7_msgs::Oem7AbasciiCmd::Response& rsp);
+
+    bool serviceOem7AbasciiBatchCb(novatel_oem7_msgs::Oem7AbasciiCmdBatch::Request& req,
+                                   novatel_oem7_msgs::Oem7AbasciiCmdBatch::Response& rsp);
+
+    void writeCommand(const std::string& cmd);
+
+    void logCommandResponse(const std::string& cmd, const std::string& rsp);
+
+    void publishLogStatisticsCb(const ros::TimerEvent&);
+
+    void publishOem7RawMsg(Oem7RawMessageIf::ConstPtr raw_msg);
+
+    void handleLog(const Oem7RawMessageIf::ConstPtr& raw_msg, const ros::Time& arrival);
+
+  public:
+    Oem7ReceiverSession(
+        const std::string& name, ///< Session name
+        ros::NodeHandle& nh      ///< Configuration namespace
+        );
+
+    ~Oem7ReceiverSession();
+
+    /**
+     * Loads the plugins and message handlers, and sets up publishing.
+     */
+    void initialize(
+        Oem7ReceiverLoader&       recvr_loader,    ///< Loader of receiver plugins; must outlive the session.
+        Oem7MessageDecoderLoader& decoder_loader,  ///< Loader of decoder plugins; must outlive the session.
+        ros::CallbackQueue*       cmd_queue,       ///< Queue servicing the command service
+        bool                      pooled           ///< Decoding is scheduled on a worker pool; see start()
+        );
+
+    /**
+     * Standalone mode: decodes and handles input until it ends. Blocks.
+     */
+    void service();
+
+    /**
+     * Pooled mode: starts reading input, decoding it on 'workers' as it becomes available.
+     */
+    void start(
+        boost::asio::io_service& workers,  ///< Worker pool
+        const std::function<void()>& on_finished ///< Called once input ends.
+        );
+
+    /**
+     * Outputs Log statistics to ROS console.
+     */
+    void outputLogStatistics();
+
+    const std::string& getName() const
+    {
+      return name_;
+    }
+
+    /**
+     * Called by decoder with new raw messages
+     */
+    void onNewMessage(Oem7RawMessageIf::ConstPtr raw_msg);
+
+    /**
+     * Called by decoder with new raw messages, and the arrival of the input which completed them.
+     */
+    void onNewStampedMessage(Oem7RawMessageIf::ConstPtr raw_msg, const Oem7InputArrival& arrival);
+  };
+}
+
+#endif
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_REPLAY_SCHEDULER_HPP__
+#define __OEM7_REPLAY_SCHEDULER_HPP__
+
+#include <ros/ros.h>
+
+#include <chrono>
+#include <thread>
+
+#include <novatel_oem7_driver/oem7_message_util.hpp>
+#include <oem7_driver_util.hpp>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Paces replay of recorded input, based on GPS time in Oem7 message headers.
+ * Messages are released at the rate they were originally generated by the receiver, scaled by a speed factor;
+ * e.g. 0.5: half speed, 1.0: real time, 10.0: ten times faster.
+ *
+ * Messages without GPS time (ASCII, NMEA) are not delayed.
+ */
+class Oem7ReplayScheduler
+{
+  typedef std::chrono::steady_clock clock_t;
+
+  static const int64_t MAX_GAP_MSEC = 10000; ///< Larger gaps in GPS time, forwards or backwards, restart pacing.
+
+  double speed_; ///< Replay speed factor; 0: disabled, as fast as possible.
+
+  bool               is_anchored_; ///< Pacing reference has been established.
+  int64_t            anchor_gps_msec_; ///< GPS time of the reference message
+  clock_t::time_point anchor_time_; ///< Wall time when the reference message was released.
+  int64_t            last_gps_msec_; ///< GPS time of the last paced message
+
+  /**
+   * Establishes a new pacing reference.
+   */
+  void anchor(int64_t gps_msec)
+  {
+    is_anchored_     = true;
+    anchor_gps_msec_ = gps_msec;
+    anchor_time_     = clock_t::now();
+  }
+
+public:
+  Oem7ReplayScheduler():
+    speed_(0.0),
+    is_anchored_(false),
+    anchor_gps_msec_(0),
+    last_gps_msec_(0)
+  {
+  }
+
+  /**
+   * Sets the replay speed factor. Factors <= 0 disable pacing.
+   */
+  void setSpeed(double speed)
+  {
+    speed_ = speed > 0.0 ? speed : 0.0;
+    is_anchored_ = false;
+  }
+
+  /**
+   * @return true if replay is paced.
+   */
+  bool isEnabled() const
+  {
+    return speed_ > 0.0;
+  }
+
+  /**
+   * Blocks until the message is due for release, according to its GPS time.
+   */
+  void pace(const Oem7RawMessageIf::ConstPtr& raw_msg)
+  {
+    if(!isEnabled())
+    {
+      return;
+    }
+
+    uint16_t gps_week;
+    uint32_t gps_msec;
+    if(!getOem7MessageGPSTime(raw_msg, gps_week, gps_msec) || gps_week == 0) // Week 0: time not yet known to receiver.
+    {
+      return;
+    }
+
+    const int64_t cur_gps_msec = GPSTimeToMsec(gps_week, gps_msec);
+
+    // Discontinuity in the recording, e.g. concatenated captures; restart pacing.
+    if(!is_anchored_ ||
+       cur_gps_msec < last_gps_msec_ - MAX_GAP_MSEC ||
+       cur_gps_msec > last_gps_msec_ + MAX_GAP_MSEC)
+    {
+      anchor(cur_gps_msec);
+    }
+
+    last_gps_msec_ = cur_gps_msec;
+
+    // Messages slightly out of order (different logs with the same time) are released immediately.
+    const int64_t elapsed_gps_usec = (cur_gps_msec - anchor_gps_msec_) * 1000;
+    if(elapsed_gps_usec <= 0)
+    {
+      return;
+    }
+
+    const clock_t::time_point release_time =
+        anchor_time_ + std::chrono::microseconds(static_cast<int64_t>(elapsed_gps_usec / speed_));
+
+    // Falling behind (e.g. slow consumers) is not compensated by skipping; output simply runs late.
+    std::this_thread::sleep_until(release_time);
+  }
+};
+
+}
+#endif
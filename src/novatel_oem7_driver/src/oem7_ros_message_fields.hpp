@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_ROS_MESSAGE_FIELDS_HPP__
+#define __OEM7_ROS_MESSAGE_FIELDS_HPP__
+
+/*! \file
+ * Compile-time field tables mapping binary Oem7 message structs (oem7_messages.h) to ROS messages.
+ *
+ * A table is a list of (ROS field, Oem7 field) member pointer pairs; the copy is generated from it and fully
+ * inlined, with the type compatibility of every pair checked at compile time. Example:
+ *
+ *   OEM7_MESSAGE_FIELDS(BESTVELMem, novatel_oem7_msgs::BESTVEL,
+ *     OEM7_NESTED_FIELD(sol_status, status, sol_stat),
+ *     OEM7_FIELD(latency,                   latency));
+ *
+ *   CopyOem7Fields(*mem, *bestvel);
+ */
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <boost/array.hpp>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Copies a single field; specialized for arrays.
+ */
+template <typename DstT, typename SrcT>
+struct Oem7FieldCopy
+{
+  static_assert(std::is_arithmetic<DstT>::value && std::is_arithmetic<SrcT>::value,
+                "Oem7 field mapping: unsupported field types");
+  static_assert(std::is_floating_point<DstT>::value || !std::is_floating_point<SrcT>::value,
+                "Oem7 field mapping: floating point field mapped to integer");
+  static_assert(std::is_floating_point<SrcT>::value || !std::is_floating_point<DstT>::value,
+                "Oem7 field mapping: integer field mapped to floating point");
+  static_assert(sizeof(DstT) >= sizeof(SrcT) || !std::is_floating_point<DstT>::value,
+                "Oem7 field mapping: floating point precision loss");
+
+  static void copy(DstT& dst, SrcT src) // By value: source fields may be unaligned.
+  {
+    dst = src;
+  }
+};
+
+/**
+ * Fixed-size character field --> string. The entire field is copied, as is.
+ */
+template <typename CharT, typename TraitsT, typename AllocT, size_t N>
+struct Oem7FieldCopy<std::basic_string<CharT, TraitsT, AllocT>, char[N]>
+{
+  static void copy(std::basic_string<CharT, TraitsT, AllocT>& dst, const char (&src)[N])
+  {
+    dst.assign(src, N);
+  }
+};
+
+/**
+ * Fixed-size array --> fixed-size array of the same extent.
+ */
+template <typename DstT, typename SrcT, size_t N>
+struct Oem7FieldCopy<boost::array<DstT, N>, SrcT[N]>
+{
+  static_assert(std::is_integral<DstT>::value && std::is_integral<SrcT>::value && sizeof(DstT) >= sizeof(SrcT),
+                "Oem7 field mapping: incompatible array element types");
+
+  static void copy(boost::array<DstT, N>& dst, const SrcT (&src)[N])
+  {
+    std::copy(src, src + N, dst.begin());
+  }
+};
+
+
+/**
+ * Maps Oem7 field MEM to ROS field ROS.
+ */
+template <typename RosPtrT, RosPtrT ROS, typename MemPtrT, MemPtrT MEM>
+struct Oem7Field
+{
+  template <typename MemT, typename RosT>
+  static void copy(const MemT& mem, RosT& ros)
+  {
+    typedef typename std::remove_reference<decltype(ros.*ROS)>::type DstT;
+    typedef typename std::remove_cv<typename std::remove_reference<decltype(mem.*MEM)>::type>::type SrcT;
+
+    Oem7FieldCopy<DstT, SrcT>::copy(ros.*ROS, mem.*MEM);
+  }
+};
+
+/**
+ * Maps Oem7 field MEM to ROS field ROS.SUB, e.g. an enum value to the 'status' member of a ROS status message.
+ */
+template <typename RosPtrT, RosPtrT ROS, typename SubPtrT, SubPtrT SUB, typename MemPtrT, MemPtrT MEM>
+struct Oem7NestedField
+{
+  template <typename MemT, typename RosT>
+  static void copy(const MemT& mem, RosT& ros)
+  {
+    typedef typename std::remove_reference<decltype((ros.*ROS).*SUB)>::type DstT;
+    typedef typename std::remove_cv<typename std::remove_reference<decltype(mem.*MEM)>::type>::type SrcT;
+
+    Oem7FieldCopy<DstT, SrcT>::copy((ros.*ROS).*SUB, mem.*MEM);
+  }
+};
+
+/**
+ * List of field mappings; copied in order.
+ */
+template <typename... FieldTs>
+struct Oem7FieldList
+{
+  template <typename MemT, typename RosT>
+  static void copy(const MemT& mem, RosT& ros)
+  {
+    const int expand[] = {0, (FieldTs::copy(mem, ros), 0)...};
+    (void)expand;
+  }
+};
+
+/**
+ * Type of the member pointed to by member pointer type PtrT.
+ */
+template <typename PtrT>
+struct Oem7MemberType;
+
+template <typename ClassT, typename MemberT>
+struct Oem7MemberType<MemberT ClassT::*>
+{
+  typedef MemberT type;
+};
+
+/**
+ * Field table of Oem7 struct MemT --> ROS message RosT; specialized with OEM7_MESSAGE_FIELDS.
+ */
+template <typename MemT, typename RosT>
+struct Oem7MessageFields;
+
+/**
+ * Copies all fields in the table of (MemT, RosT).
+ */
+template <typename MemT, typename RosT>
+inline void CopyOem7Fields(const MemT& mem, RosT& ros)
+{
+  Oem7MessageFields<MemT, RosT>::Fields::copy(mem, ros);
+}
+
+}
+
+
+/// Maps Oem7 field MEM_FIELD to ROS field ROS_FIELD; use within OEM7_MESSAGE_FIELDS.
+#define OEM7_FIELD(ROS_FIELD, MEM_FIELD)                        \
+  ::novatel_oem7_driver::Oem7Field<                             \
+    decltype(&RosT::ROS_FIELD), &RosT::ROS_FIELD,               \
+    decltype(&MemT::MEM_FIELD), &MemT::MEM_FIELD>
+
+/// Maps Oem7 field MEM_FIELD to ROS field ROS_FIELD.ROS_SUBFIELD; use within OEM7_MESSAGE_FIELDS.
+#define OEM7_NESTED_FIELD(ROS_FIELD, ROS_SUBFIELD, MEM_FIELD)   \
+  ::novatel_oem7_driver::Oem7NestedField<                       \
+    decltype(&RosT::ROS_FIELD), &RosT::ROS_FIELD,               \
+    decltype(&::novatel_oem7_driver::Oem7MemberType<decltype(&RosT::ROS_FIELD)>::type::ROS_SUBFIELD), \
+             &::novatel_oem7_driver::Oem7MemberType<decltype(&RosT::ROS_FIELD)>::type::ROS_SUBFIELD,  \
+    decltype(&MemT::MEM_FIELD), &MemT::MEM_FIELD>
+
+/// Defines the field table of Oem7 struct MEM --> ROS message ROS. Must be used in namespace novatel_oem7_driver.
+#define OEM7_MESSAGE_FIELDS(MEM, ROS, ...)                      \
+  template <>                                                   \
+  struct Oem7MessageFields<MEM, ROS>                            \
+  {                                                             \
+    typedef MEM MemT;                                           \
+    typedef ROS RosT;                                           \
+    typedef ::novatel_oem7_driver::Oem7FieldList<__VA_ARGS__> Fields; \
+  }
+
+#endif
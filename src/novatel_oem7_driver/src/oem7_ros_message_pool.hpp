@@ -0,0 +1,267 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_ROS_MESSAGE_POOL_HPP__
+#define __OEM7_ROS_MESSAGE_POOL_HPP__
+
+#include <ros/message_traits.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/pool/pool_alloc.hpp>
+
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Usage statistics of a single ROS message pool.
+ */
+struct Oem7RosMessagePoolStats
+{
+  std::string type;  ///< ROS message type, e.g. 'sensor_msgs/Imu'
+  uint64_t hits;     ///< Allocations served from the pool
+  uint64_t misses;   ///< Allocations served from the heap
+  uint64_t recycled; ///< Messages returned to the pool
+  uint64_t dropped;  ///< Messages deleted on release because the pool was full
+  size_t   free;     ///< Messages currently available in the pool
+};
+
+class Oem7RosMessagePoolIf
+{
+public:
+  virtual ~Oem7RosMessagePoolIf() {}
+  virtual void getStats(Oem7RosMessagePoolStats& stats) = 0;
+};
+
+/**
+ * Keeps track of all message pools, for statistics reporting and configuration.
+ */
+class Oem7RosMessagePoolRegistry
+{
+  std::mutex mtx_;
+  std::vector<Oem7RosMessagePoolIf*> pools_;
+  std::atomic<size_t> capacity_;
+
+  enum
+  {
+    DEFAULT_POOL_CAPACITY = 32 ///< Max free messages retained per message type.
+  };
+
+  Oem7RosMessagePoolRegistry():
+    capacity_(DEFAULT_POOL_CAPACITY)
+  {
+  }
+
+public:
+  static Oem7RosMessagePoolRegistry& instance()
+  {
+    static Oem7RosMessagePoolRegistry registry;
+    return registry;
+  }
+
+  /**
+   * Sets the max number of free messages retained by each pool; 0 disables pooling.
+   */
+  void setCapacity(size_t capacity)
+  {
+    capacity_ = capacity;
+  }
+
+  size_t getCapacity() const
+  {
+    return capacity_;
+  }
+
+  void add(Oem7RosMessagePoolIf* pool)
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    pools_.push_back(pool);
+  }
+
+  void remove(Oem7RosMessagePoolIf* pool)
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    pools_.erase(std::remove(pools_.begin(), pools_.end(), pool), pools_.end());
+  }
+
+  void getStats(std::vector<Oem7RosMessagePoolStats>& stats)
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stats.resize(pools_.size());
+    for(size_t i = 0; i < pools_.size(); i++)
+    {
+      pools_[i]->getStats(stats[i]);
+    }
+  }
+};
+
+
+/**
+ * Pool of recycled ROS messages of type T.
+ *
+ * Messages are handed out through shared_ptr with a custom deleter; when the last reference is released,
+ * (e.g. by intra-process subscribers), the message is reset to its default value and returned to the pool.
+ * Resetting by copy-assignment retains the capacity of string and vector members.
+ */
+template <class T>
+class Oem7RosMessagePool: public Oem7RosMessagePoolIf
+{
+  /**
+   * Pool storage; shared with outstanding messages, so that they can be released after the pool is gone.
+   */
+  struct Storage
+  {
+    std::mutex      mtx;
+    std::vector<T*> free;
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> recycled;
+    std::atomic<uint64_t> dropped;
+
+    Storage(): hits(0), misses(0), recycled(0), dropped(0) {}
+
+    ~Storage()
+    {
+      for(size_t i = 0; i < free.size(); i++)
+      {
+        delete free[i];
+      }
+    }
+
+    void release(T* msg)
+    {
+      static const T default_msg;
+      *msg = default_msg;
+
+      {
+        std::lock_guard<std::mutex> lk(mtx);
+        if(free.size() < Oem7RosMessagePoolRegistry::instance().getCapacity())
+        {
+          free.push_back(msg);
+          msg = NULL;
+        }
+      }
+
+      if(msg)
+      {
+        dropped++;
+        delete msg;
+      }
+      else
+      {
+        recycled++;
+      }
+    }
+  };
+
+  struct Recycler
+  {
+    boost::shared_ptr<Storage> storage;
+
+    void operator()(T* msg)
+    {
+      storage->release(msg);
+    }
+  };
+
+  boost::shared_ptr<Storage> storage_;
+
+  Oem7RosMessagePool():
+    storage_(boost::make_shared<Storage>())
+  {
+    Oem7RosMessagePoolRegistry::instance().add(this);
+  }
+
+public:
+  ~Oem7RosMessagePool()
+  {
+    Oem7RosMessagePoolRegistry::instance().remove(this);
+  }
+
+  static Oem7RosMessagePool& instance()
+  {
+    static Oem7RosMessagePool pool;
+    return pool;
+  }
+
+  boost::shared_ptr<T> alloc()
+  {
+    T* msg = NULL;
+    {
+      std::lock_guard<std::mutex> lk(storage_->mtx);
+      if(!storage_->free.empty())
+      {
+        msg = storage_->free.back();
+        storage_->free.pop_back();
+      }
+    }
+
+    if(msg)
+    {
+      storage_->hits++;
+    }
+    else
+    {
+      storage_->misses++;
+      msg = new T;
+    }
+
+    // Reference counts are allocated from a pool too, so that a recycled message costs no heap allocations.
+    Recycler recycler = {storage_};
+    return boost::shared_ptr<T>(msg, recycler, boost::fast_pool_allocator<T>());
+  }
+
+  virtual void getStats(Oem7RosMessagePoolStats& stats)
+  {
+    stats.type     = ros::message_traits::DataType<T>::value();
+    stats.hits     = storage_->hits;
+    stats.misses   = storage_->misses;
+    stats.recycled = storage_->recycled;
+    stats.dropped  = storage_->dropped;
+
+    std::lock_guard<std::mutex> lk(storage_->mtx);
+    stats.free = storage_->free.size();
+  }
+};
+
+
+/**
+ * Allocates a default-valued ROS message, recycled through a per-type pool.
+ */
+template <class T>
+boost::shared_ptr<T> AllocROSMessage()
+{
+  return Oem7RosMessagePool<T>::instance().alloc();
+}
+
+}
+#endif
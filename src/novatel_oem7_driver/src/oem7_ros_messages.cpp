@@ -32,6 +32,10 @@
 #include "novatel_oem7_driver/oem7_messages.h"
 #include "novatel_oem7_driver/oem7_message_util.hpp"
 
+#include "oem7_ros_message_pool.hpp"
+#include "oem7_ros_message_fields.hpp"
+
+
 
 #include "novatel_oem7_msgs/HEADING2.h"
 #include "novatel_oem7_msgs/BESTPOS.h"
@@ -41,28 +45,17 @@
 #include "novatel_oem7_msgs/INSPVAX.h"
 #include "novatel_oem7_msgs/INSCONFIG.h"
 #include "novatel_oem7_msgs/INSSTDEV.h"
+#include "novatel_oem7_msgs/INSUPDATESTATUS.h"
 #include "novatel_oem7_msgs/CORRIMU.h"
 #include "novatel_oem7_msgs/RXSTATUS.h"
 #include "novatel_oem7_msgs/TIME.h"
+#include "novatel_oem7_msgs/RANGE.h"
 
 
 
-#define arr_size(_arr_) (sizeof(_arr_) / sizeof(_arr_[0]))
-
 namespace novatel_oem7_driver
 {
 
-/**
- * Generate ROS message sequence number
- * @return sequence number
- */
-uint32_t GetNextMsgSequenceNumber()
-{
-  static uint32_t sequence_number = 0;
-
-  return ++sequence_number;
-}
-
 /*
  * Populates Oem7header from raw message
  */
@@ -91,167 +84,346 @@ SetOem7ShortHeader(
   oem7_hdr.message_name = name;
 }
 
-// Template specializations from specific messages
-
-template<>
+/**
+ * Makes a ROS message from an Oem7 message with a fixed-size body, using the field table of (MemT, RosT).
+ */
+template <typename MemT, typename RosT>
 void
-MakeROSMessage<novatel_oem7_msgs::HEADING2>(
-    const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::HEADING2>& heading2)
+MakeROSMessageFromFields(
+    const Oem7RawMessageIf::ConstPtr& msg, ///< in: raw message
+    size_t hdr_len,                        ///< binary header length: long or short
+    const std::string& name,               ///< message name
+    boost::shared_ptr<RosT>& rosmsg        ///< out: ROS message
+    )
 {
-  assert(msg->getMessageId() == HEADING2_OEM7_MSGID);
-
-  const HEADING2Mem* mem = reinterpret_cast<const HEADING2Mem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  heading2.reset(new novatel_oem7_msgs::HEADING2);
-
-  heading2->sol_status.status     = mem->sol_status;
-  heading2->pos_type.type         = mem->pos_type;
-  heading2->length                = mem->length;
-  heading2->heading               = mem->heading;
-  heading2->pitch                 = mem->pitch;
-  heading2->reserved              = mem->reserved;
-  heading2->heading_stdev         = mem->heading_stdev;
-  heading2->pitch_stdev           = mem->pitch_stdev;
-  heading2->rover_stn_id.assign( mem->rover_stn_id,    arr_size(mem->rover_stn_id));
-  heading2->master_stn_id.assign(mem->master_stn_id,   arr_size(mem->rover_stn_id));
-  heading2->num_sv_tracked          = mem->num_sv_tracked;
-  heading2->num_sv_in_sol           = mem->num_sv_in_sol;
-  heading2->num_sv_obs              = mem->num_sv_obs;
-  heading2->num_sv_multi            = mem->num_sv_multi;
-  heading2->sol_source.source       = mem->sol_source;
-  heading2->ext_sol_status.status   = mem->ext_sol_status;
-  heading2->galileo_beidou_sig_mask = mem->galileo_beidou_sig_mask;
-  heading2->gps_glonass_sig_mask    = mem->gps_glonass_sig_mask;
-
-  static const std::string name = "HEADING2";
-  SetOem7Header(msg, name, heading2->nov_header);
-}
+  const MemT* mem = reinterpret_cast<const MemT*>(msg->getMessageData(hdr_len));
+  rosmsg = AllocROSMessage<RosT>();
 
-template<>
-void
-MakeROSMessage<novatel_oem7_msgs::BESTPOS>(
-    const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::BESTPOS>& bestpos)
-{
-  assert(msg->getMessageId() == BESTPOS_OEM7_MSGID);
-
-  const BESTPOSMem* bp = reinterpret_cast<const BESTPOSMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  bestpos.reset(new novatel_oem7_msgs::BESTPOS);
-
-  bestpos->sol_status.status      = bp->sol_stat;
-  bestpos->pos_type.type          = bp->pos_type;
-  bestpos->lat                    = bp->lat;
-  bestpos->lon                    = bp->lon;
-  bestpos->hgt                    = bp->hgt;
-  bestpos->undulation             = bp->undulation;
-  bestpos->datum_id               = bp->datum_id;
-  bestpos->lat_stdev              = bp->lat_stdev;
-  bestpos->lon_stdev              = bp->lon_stdev;
-  bestpos->hgt_stdev              = bp->hgt_stdev;
-  bestpos->stn_id.assign(           bp->stn_id, arr_size(bp->stn_id));
-  bestpos->diff_age               = bp->diff_age;
-  bestpos->sol_age                = bp->sol_age;
-  bestpos->num_svs                = bp->num_svs;
-  bestpos->num_sol_svs            = bp->num_sol_svs;
-  bestpos->num_sol_l1_svs         = bp->num_sol_l1_svs;
-  bestpos->num_sol_multi_svs      = bp->num_sol_multi_svs;
-  bestpos->reserved               = bp->reserved;
-  bestpos->ext_sol_stat.status    = bp->ext_sol_stat;
-  bestpos->galileo_beidou_sig_mask= bp->galileo_beidou_sig_mask;
-  bestpos->gps_glonass_sig_mask   = bp->gps_glonass_sig_mask;
-
-  static const std::string name = "BESTPOS";
-  SetOem7Header(msg, name, bestpos->nov_header);
-}
+  CopyOem7Fields(*mem, *rosmsg);
 
-template<>
-void
-MakeROSMessage<novatel_oem7_msgs::BESTVEL>(
-    const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::BESTVEL>& bestvel)
-{
-  assert(msg->getMessageId() == BESTVEL_OEM7_MSGID);
-
-  const BESTVELMem* bv = reinterpret_cast<const BESTVELMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  bestvel.reset(new novatel_oem7_msgs::BESTVEL);
-
-  bestvel->sol_status.status = bv->sol_stat;
-  bestvel->vel_type.type     = bv->vel_type;
-  bestvel->latency           = bv->latency;
-  bestvel->diff_age          = bv->diff_age;
-  bestvel->hor_speed         = bv->hor_speed;
-  bestvel->trk_gnd           = bv->track_gnd;
-  bestvel->ver_speed         = bv->ver_speed;
-  bestvel->reserved          = bv->reserved;
-
-  static const std::string name = "BESTVEL";
-  SetOem7Header(msg, name, bestvel->nov_header);
+  if(hdr_len == OEM7_BINARY_MSG_SHORT_HDR_LEN)
+  {
+    SetOem7ShortHeader(msg, name, rosmsg->nov_header);
+  }
+  else
+  {
+    SetOem7Header(msg, name, rosmsg->nov_header);
+  }
 }
 
+/**
+ * Defines the field table of a ROS message generated from a single Oem7 message with a fixed-size body,
+ * and its MakeROSMessage specialization.
+ */
+#define OEM7_ROS_MESSAGE(NAME, MSGID, MEM, HDR_LEN, ...)                              \
+  OEM7_MESSAGE_FIELDS(MEM, novatel_oem7_msgs::NAME, __VA_ARGS__);                     \
+                                                                                      \
+  template<>                                                                          \
+  void                                                                                \
+  MakeROSMessage<novatel_oem7_msgs::NAME>(                                            \
+      const Oem7RawMessageIf::ConstPtr& msg,                                          \
+      boost::shared_ptr<novatel_oem7_msgs::NAME>& rosmsg)                             \
+  {                                                                                   \
+    assert(msg->getMessageId() == MSGID);                                             \
+                                                                                      \
+    static const std::string name = #NAME;                                            \
+    MakeROSMessageFromFields<MEM>(msg, HDR_LEN, name, rosmsg);                        \
+  }
+
+
+// Field tables of specific messages
+
+OEM7_ROS_MESSAGE(BESTPOS, BESTPOS_OEM7_MSGID, BESTPOSMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_NESTED_FIELD(sol_status,   status, sol_stat),
+  OEM7_NESTED_FIELD(pos_type,     type,   pos_type),
+  OEM7_FIELD(lat,                         lat),
+  OEM7_FIELD(lon,                         lon),
+  OEM7_FIELD(hgt,                         hgt),
+  OEM7_FIELD(undulation,                  undulation),
+  OEM7_FIELD(datum_id,                    datum_id),
+  OEM7_FIELD(lat_stdev,                   lat_stdev),
+  OEM7_FIELD(lon_stdev,                   lon_stdev),
+  OEM7_FIELD(hgt_stdev,                   hgt_stdev),
+  OEM7_FIELD(stn_id,                      stn_id),
+  OEM7_FIELD(diff_age,                    diff_age),
+  OEM7_FIELD(sol_age,                     sol_age),
+  OEM7_FIELD(num_svs,                     num_svs),
+  OEM7_FIELD(num_sol_svs,                 num_sol_svs),
+  OEM7_FIELD(num_sol_l1_svs,              num_sol_l1_svs),
+  OEM7_FIELD(num_sol_multi_svs,           num_sol_multi_svs),
+  OEM7_FIELD(reserved,                    reserved),
+  OEM7_NESTED_FIELD(ext_sol_stat, status, ext_sol_stat),
+  OEM7_FIELD(galileo_beidou_sig_mask,     galileo_beidou_sig_mask),
+  OEM7_FIELD(gps_glonass_sig_mask,        gps_glonass_sig_mask))
+
+OEM7_ROS_MESSAGE(BESTVEL, BESTVEL_OEM7_MSGID, BESTVELMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_NESTED_FIELD(sol_status, status, sol_stat),
+  OEM7_NESTED_FIELD(vel_type,   type,   vel_type),
+  OEM7_FIELD(latency,                   latency),
+  OEM7_FIELD(diff_age,                  diff_age),
+  OEM7_FIELD(hor_speed,                 hor_speed),
+  OEM7_FIELD(trk_gnd,                   track_gnd),
+  OEM7_FIELD(ver_speed,                 ver_speed),
+  OEM7_FIELD(reserved,                  reserved))
+
+OEM7_ROS_MESSAGE(BESTUTM, BESTUTM_OEM7_MSGID, BESTUTMMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_NESTED_FIELD(sol_status,   status, sol_stat),
+  OEM7_NESTED_FIELD(pos_type,     type,   pos_type),
+  OEM7_FIELD(lon_zone_number,             lon_zone_number),
+  OEM7_FIELD(lat_zone_letter,             lat_zone_letter),
+  OEM7_FIELD(northing,                    northing),
+  OEM7_FIELD(easting,                     easting),
+  OEM7_FIELD(height,                      height),
+  OEM7_FIELD(undulation,                  undulation),
+  OEM7_FIELD(datum_id,                    datum_id),
+  OEM7_FIELD(northing_stddev,             northing_stddev),
+  OEM7_FIELD(easting_stddev,              easting_stddev),
+  OEM7_FIELD(height_stddev,               height_stddev),
+  OEM7_FIELD(stn_id,                      stn_id),
+  OEM7_FIELD(diff_age,                    diff_age),
+  OEM7_FIELD(sol_age,                     sol_age),
+  OEM7_FIELD(num_svs,                     num_svs),
+  OEM7_FIELD(num_sol_svs,                 num_sol_svs),
+  OEM7_FIELD(num_sol_ggl1_svs,            num_sol_ggl1_svs),
+  OEM7_FIELD(num_sol_multi_svs,           num_sol_multi_svs),
+  OEM7_FIELD(reserved,                    reserved),
+  OEM7_NESTED_FIELD(ext_sol_stat, status, ext_sol_stat),
+  OEM7_FIELD(galileo_beidou_sig_mask,     galileo_beidou_sig_mask),
+  OEM7_FIELD(gps_glonass_sig_mask,        gps_glonass_sig_mask))
+
+OEM7_ROS_MESSAGE(INSPVA, INSPVAS_OEM7_MSGID, INSPVASmem, OEM7_BINARY_MSG_SHORT_HDR_LEN,
+  OEM7_FIELD(latitude,              latitude),
+  OEM7_FIELD(longitude,             longitude),
+  OEM7_FIELD(height,                height),
+  OEM7_FIELD(north_velocity,        north_velocity),
+  OEM7_FIELD(east_velocity,         east_velocity),
+  OEM7_FIELD(up_velocity,           up_velocity),
+  OEM7_FIELD(roll,                  roll),
+  OEM7_FIELD(pitch,                 pitch),
+  OEM7_FIELD(azimuth,               azimuth),
+  OEM7_NESTED_FIELD(status, status, status))
+
+OEM7_ROS_MESSAGE(INSPVAX, INSPVAX_OEM7_MSGID, INSPVAXMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_NESTED_FIELD(ins_status,     status, ins_status),
+  OEM7_NESTED_FIELD(pos_type,       type,   pos_type),
+  OEM7_FIELD(latitude,                      latitude),
+  OEM7_FIELD(longitude,                     longitude),
+  OEM7_FIELD(height,                        height),
+  OEM7_FIELD(undulation,                    undulation),
+  OEM7_FIELD(north_velocity,                north_velocity),
+  OEM7_FIELD(east_velocity,                 east_velocity),
+  OEM7_FIELD(up_velocity,                   up_velocity),
+  OEM7_FIELD(roll,                          roll),
+  OEM7_FIELD(pitch,                         pitch),
+  OEM7_FIELD(azimuth,                       azimuth),
+  OEM7_FIELD(latitude_stdev,                latitude_stdev),
+  OEM7_FIELD(longitude_stdev,               longitude_stdev),
+  OEM7_FIELD(height_stdev,                  height_stdev),
+  OEM7_FIELD(north_velocity_stdev,          north_velocity_stdev),
+  OEM7_FIELD(east_velocity_stdev,           east_velocity_stdev),
+  OEM7_FIELD(up_velocity_stdev,             up_velocity_stdev),
+  OEM7_FIELD(roll_stdev,                    roll_stdev),
+  OEM7_FIELD(pitch_stdev,                   pitch_stdev),
+  OEM7_FIELD(azimuth_stdev,                 azimuth_stdev),
+  OEM7_NESTED_FIELD(ext_sol_status, status, extended_status),
+  OEM7_FIELD(time_since_update,             time_since_update))
+
+OEM7_ROS_MESSAGE(INSSTDEV, INSSTDEV_OEM7_MSGID, INSSTDEVMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_FIELD(latitude_stdev,                latitude_stdev),
+  OEM7_FIELD(longitude_stdev,               longitude_stdev),
+  OEM7_FIELD(height_stdev,                  height_stdev),
+  OEM7_FIELD(north_velocity_stdev,          north_velocity_stdev),
+  OEM7_FIELD(east_velocity_stdev,           east_velocity_stdev),
+  OEM7_FIELD(up_velocity_stdev,             up_velocity_stdev),
+  OEM7_FIELD(roll_stdev,                    roll_stdev),
+  OEM7_FIELD(pitch_stdev,                   pitch_stdev),
+  OEM7_FIELD(azimuth_stdev,                 azimuth_stdev),
+  OEM7_NESTED_FIELD(ext_sol_status, status, ext_sol_status),
+  OEM7_FIELD(time_since_last_update,        time_since_last_update),
+  OEM7_FIELD(reserved1,                     reserved1),
+  OEM7_FIELD(reserved2,                     reserved2),
+  OEM7_FIELD(reserved3,                     reserved3))
+
+OEM7_ROS_MESSAGE(INSUPDATESTATUS, INSUPDATESTATUS_OEM7_MSGID, INSUPDATESTATUSMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_NESTED_FIELD(pos_type,       type,   pos_type),
+  OEM7_FIELD(num_psr,                       num_psr),
+  OEM7_FIELD(num_adr,                       num_adr),
+  OEM7_FIELD(num_dop,                       num_dop),
+  OEM7_FIELD(dmi_update_status,             dmi_update_status),
+  OEM7_FIELD(heading_update_status,         heading_update_status),
+  OEM7_NESTED_FIELD(ext_sol_status, status, ext_sol_status),
+  OEM7_FIELD(update_option_indicators,      update_option_indicators),
+  OEM7_FIELD(reserved1,                     reserved1),
+  OEM7_FIELD(reserved2,                     reserved2))
+
+OEM7_ROS_MESSAGE(TIME, TIME_OEM7_MSGID, TIMEMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_FIELD(clock_status,  clock_status),
+  OEM7_FIELD(offset,        offset),
+  OEM7_FIELD(offset_std,    offset_std),
+  OEM7_FIELD(utc_offset,    utc_offset),
+  OEM7_FIELD(utc_year,      utc_year),
+  OEM7_FIELD(utc_month,     utc_month),
+  OEM7_FIELD(utc_day,       utc_day),
+  OEM7_FIELD(utc_hour,      utc_hour),
+  OEM7_FIELD(utc_min,       utc_min),
+  OEM7_FIELD(utc_msec,      utc_msec),
+  OEM7_FIELD(utc_status,    utc_status))
+
+OEM7_ROS_MESSAGE(RXSTATUS, RXSTATUS_OEM7_MSGID, RXSTATUSMem, OEM7_BINARY_MSG_HDR_LEN,
+  OEM7_FIELD(error,             error),
+  OEM7_FIELD(num_status_codes,  num_status_codes),
+  OEM7_FIELD(rxstat,            rxstat),
+  OEM7_FIELD(rxstat_pri_mask,   rxstat_pri_mask),
+  OEM7_FIELD(rxstat_set_mask,   rxstat_set_mask),
+  OEM7_FIELD(rxstat_clr_mask,   rxstat_clr_mask),
+  OEM7_FIELD(aux1_stat,         aux1_stat),
+  OEM7_FIELD(aux1_stat_pri,     aux1_stat_pri),
+  OEM7_FIELD(aux1_stat_set,     aux1_stat_set),
+  OEM7_FIELD(aux1_stat_clr,     aux1_stat_clr),
+  OEM7_FIELD(aux2_stat,         aux2_stat),
+  OEM7_FIELD(aux2_stat_pri,     aux2_stat_pri),
+  OEM7_FIELD(aux2_stat_set,     aux2_stat_set),
+  OEM7_FIELD(aux2_stat_clr,     aux2_stat_clr),
+  OEM7_FIELD(aux3_stat,         aux3_stat),
+  OEM7_FIELD(aux3_stat_pri,     aux3_stat_pri),
+  OEM7_FIELD(aux3_stat_set,     aux3_stat_set),
+  OEM7_FIELD(aux3_stat_clr,     aux3_stat_clr),
+  OEM7_FIELD(aux4_stat,         aux4_stat),
+  OEM7_FIELD(aux4_stat_pri,     aux4_stat_pri),
+  OEM7_FIELD(aux4_stat_set,     aux4_stat_set),
+  OEM7_FIELD(aux4_stat_clr,     aux4_stat_clr))
+
+
+// Messages generated from more than one Oem7 message, or with variable-size bodies.
+
+OEM7_MESSAGE_FIELDS(HEADING2Mem, novatel_oem7_msgs::HEADING2,
+  OEM7_NESTED_FIELD(sol_status,     status, sol_status),
+  OEM7_NESTED_FIELD(pos_type,       type,   pos_type),
+  OEM7_FIELD(length,                        length),
+  OEM7_FIELD(heading,                       heading),
+  OEM7_FIELD(pitch,                         pitch),
+  OEM7_FIELD(reserved,                      reserved),
+  OEM7_FIELD(heading_stdev,                 heading_stdev),
+  OEM7_FIELD(pitch_stdev,                   pitch_stdev),
+  OEM7_FIELD(rover_stn_id,                  rover_stn_id),
+  OEM7_FIELD(master_stn_id,                 master_stn_id),
+  OEM7_FIELD(num_sv_tracked,                num_sv_tracked),
+  OEM7_FIELD(num_sv_in_sol,                 num_sv_in_sol),
+  OEM7_FIELD(num_sv_obs,                    num_sv_obs),
+  OEM7_FIELD(num_sv_multi,                  num_sv_multi),
+  OEM7_NESTED_FIELD(sol_source,     source, sol_source),
+  OEM7_NESTED_FIELD(ext_sol_status, status, ext_sol_status),
+  OEM7_FIELD(galileo_beidou_sig_mask,       galileo_beidou_sig_mask),
+  OEM7_FIELD(gps_glonass_sig_mask,          gps_glonass_sig_mask));
+
+/*
+ * HEADING2 and DUALANTENNAHEADING share the same format.
+ */
 template<>
 void
-MakeROSMessage<novatel_oem7_msgs::BESTUTM>(
+MakeROSMessage<novatel_oem7_msgs::HEADING2>(
     const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::BESTUTM>& bestutm)
+    boost::shared_ptr<novatel_oem7_msgs::HEADING2>& heading2)
 {
-    assert(msg->getMessageId() == BESTUTM_OEM7_MSGID);
-
-    const BESTUTMMem* mem = reinterpret_cast<const BESTUTMMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-    bestutm.reset(new novatel_oem7_msgs::BESTUTM);
-
-    bestutm->pos_type.type          = mem->pos_type;;
-    bestutm->lon_zone_number        = mem->lon_zone_number;
-    bestutm->lat_zone_letter        = mem->lat_zone_letter;
-    bestutm->northing               = mem->northing;
-    bestutm->easting                = mem->easting;
-    bestutm->height                 = mem->height;
-    bestutm->undulation             = mem->undulation;
-    bestutm->datum_id               = mem->datum_id;
-    bestutm->northing_stddev        = mem->northing_stddev;
-    bestutm->easting_stddev         = mem->easting_stddev;
-    bestutm->height_stddev          = mem->height_stddev;
-    bestutm->stn_id.assign(           mem->stn_id, arr_size(mem->stn_id));
-    bestutm->diff_age               = mem->diff_age;
-    bestutm->sol_age                = mem->sol_age;
-    bestutm->num_svs                = mem->num_svs;
-    bestutm->num_sol_svs            = mem->num_sol_svs;
-    bestutm->num_sol_ggl1_svs       = mem->num_sol_ggl1_svs;
-    bestutm->num_sol_multi_svs      = mem->num_sol_multi_svs;
-    bestutm->reserved               = mem->reserved;
-    bestutm->ext_sol_stat.status    = mem->ext_sol_stat;
-    bestutm->galileo_beidou_sig_mask= mem->galileo_beidou_sig_mask;
-    bestutm->gps_glonass_sig_mask   = mem->gps_glonass_sig_mask;
-
-    static const std::string name = "BESTUTM";
-    SetOem7Header(msg, name, bestutm->nov_header);
+  static const std::string HEADING2_name           = "HEADING2";
+  static const std::string DUALANTENNAHEADING_name = "DUALANTENNAHEADING";
+
+  if(msg->getMessageId() == HEADING2_OEM7_MSGID)
+  {
+    MakeROSMessageFromFields<HEADING2Mem>(msg, OEM7_BINARY_MSG_HDR_LEN, HEADING2_name, heading2);
+  }
+  else if(msg->getMessageId() == DUALANTENNAHEADING_OEM7_MSGID)
+  {
+    MakeROSMessageFromFields<HEADING2Mem>(msg, OEM7_BINARY_MSG_HDR_LEN, DUALANTENNAHEADING_name, heading2);
+  }
+  else
+  {
+    assert(false);
   }
+}
+
+OEM7_MESSAGE_FIELDS(CORRIMUSMem, novatel_oem7_msgs::CORRIMU,
+  OEM7_FIELD(imu_data_count,    imu_data_count),
+  OEM7_FIELD(pitch_rate,        pitch_rate),
+  OEM7_FIELD(roll_rate,         roll_rate),
+  OEM7_FIELD(yaw_rate,          yaw_rate),
+  OEM7_FIELD(lateral_acc,       lateral_acc),
+  OEM7_FIELD(longitudinal_acc,  longitudinal_acc),
+  OEM7_FIELD(vertical_acc,      vertical_acc));
+
+OEM7_MESSAGE_FIELDS(IMURATECORRIMUSMem, novatel_oem7_msgs::CORRIMU,
+  OEM7_FIELD(pitch_rate,        pitch_rate),
+  OEM7_FIELD(roll_rate,         roll_rate),
+  OEM7_FIELD(yaw_rate,          yaw_rate),
+  OEM7_FIELD(lateral_acc,       lateral_acc),
+  OEM7_FIELD(longitudinal_acc,  longitudinal_acc),
+  OEM7_FIELD(vertical_acc,      vertical_acc));
 
 template<>
 void
-MakeROSMessage<novatel_oem7_msgs::INSPVA>(
+MakeROSMessage<novatel_oem7_msgs::CORRIMU>(
     const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::INSPVA>& pva)
+    boost::shared_ptr<novatel_oem7_msgs::CORRIMU>& corrimu)
 {
-  assert(msg->getMessageId() == INSPVAS_OEM7_MSGID);
-
-  const INSPVASmem* pvamem = reinterpret_cast<const INSPVASmem*>(msg->getMessageData(OEM7_BINARY_MSG_SHORT_HDR_LEN));
-  pva.reset(new novatel_oem7_msgs::INSPVA);
-
-  pva->latitude        =     pvamem->latitude;
-  pva->longitude       =     pvamem->longitude;
-  pva->height          =     pvamem->height;
-  pva->north_velocity  =     pvamem->north_velocity;
-  pva->east_velocity   =     pvamem->east_velocity;
-  pva->up_velocity     =     pvamem->up_velocity;
-  pva->roll            =     pvamem->roll;
-  pva->pitch           =     pvamem->pitch;
-  pva->azimuth         =     pvamem->azimuth;
-  pva->status.status   =     pvamem->status;
-
-  static const std::string name = "INSPVA";
-  SetOem7ShortHeader(msg, name, pva->nov_header);
+  static const std::string name = "CORRIMU";
+
+  if(msg->getMessageId() == CORRIMUS_OEM7_MSGID)
+  {
+    MakeROSMessageFromFields<CORRIMUSMem>(msg, OEM7_BINARY_MSG_SHORT_HDR_LEN, name, corrimu);
+  }
+  else if(msg->getMessageId() == IMURATECORRIMUS_OEM7_MSGID)
+  {
+    MakeROSMessageFromFields<IMURATECORRIMUSMem>(msg, OEM7_BINARY_MSG_SHORT_HDR_LEN, name, corrimu);
+    corrimu->imu_data_count = 0; // FIXME
+  }
+  else
+  {
+    assert(false);
+  }
 }
 
+OEM7_MESSAGE_FIELDS(INSCONFIG_FixedMem, novatel_oem7_msgs::INSCONFIG,
+  OEM7_FIELD(imu_type,                                    imu_type),
+  OEM7_FIELD(mapping,                                     mapping),
+  OEM7_FIELD(initial_alignment_velocity,                  initial_alignment_velocity),
+  OEM7_FIELD(heave_window,                                heave_window),
+  OEM7_FIELD(profile,                                     profile),
+  OEM7_FIELD(enabled_updates,                             enabled_updates),
+  OEM7_NESTED_FIELD(alignment_mode,            mode,      alignment_mode),
+  OEM7_NESTED_FIELD(relative_ins_output_frame, frame,     relative_ins_output_frame),
+  OEM7_FIELD(relative_ins_output_direction,               relative_ins_output_direction),
+  OEM7_NESTED_FIELD(ins_receiver_status,       status,    ins_receiver_status),
+  OEM7_FIELD(ins_seed_enabled,                            ins_seed_enabled),
+  OEM7_FIELD(ins_seed_validation,                         ins_seed_validation),
+  OEM7_FIELD(reserved_1,                                  reserved_1),
+  OEM7_FIELD(reserved_2,                                  reserved_2),
+  OEM7_FIELD(reserved_3,                                  reserved_3),
+  OEM7_FIELD(reserved_4,                                  reserved_4),
+  OEM7_FIELD(reserved_5,                                  reserved_5),
+  OEM7_FIELD(reserved_6,                                  reserved_6),
+  OEM7_FIELD(reserved_7,                                  reserved_7));
+
+OEM7_MESSAGE_FIELDS(INSCONFIG_TranslationMem, novatel_oem7_msgs::Translation,
+  OEM7_NESTED_FIELD(translation,        type,   translation),
+  OEM7_NESTED_FIELD(frame,              frame,  frame),
+  OEM7_FIELD(x_offset,                          x_offset),
+  OEM7_FIELD(y_offset,                          y_offset),
+  OEM7_FIELD(z_offset,                          z_offset),
+  OEM7_FIELD(x_uncertainty,                     x_uncertainty),
+  OEM7_FIELD(y_uncertainty,                     y_uncertainty),
+  OEM7_FIELD(z_uncertainty,                     z_uncertainty),
+  OEM7_NESTED_FIELD(translation_source, status, translation_source));
+
+OEM7_MESSAGE_FIELDS(INSCONFIG_RotationMem, novatel_oem7_msgs::Rotation,
+  OEM7_NESTED_FIELD(rotation,        offset, rotation),
+  OEM7_NESTED_FIELD(frame,           frame,  frame),
+  OEM7_FIELD(x_rotation,                     x_rotation),
+  OEM7_FIELD(y_rotation,                     y_rotation),
+  OEM7_FIELD(z_rotation,                     z_rotation),
+  OEM7_FIELD(x_rotation_stdev,               x_rotation_stdev),
+  OEM7_FIELD(y_rotation_stdev,               y_rotation_stdev),
+  OEM7_FIELD(z_rotation_stdev,               z_rotation_stdev),
+  OEM7_NESTED_FIELD(rotation_source, status, rotation_source));
 
 template<>
 void
@@ -261,258 +433,117 @@ MakeROSMessage<novatel_oem7_msgs::INSCONFIG>(
 {
   assert(msg->getMessageId()== INSCONFIG_OEM7_MSGID);
 
+  static const std::string name = "INSCONFIG";
+  MakeROSMessageFromFields<INSCONFIG_FixedMem>(msg, OEM7_BINARY_MSG_HDR_LEN, name, insconfig);
+
   const INSCONFIG_FixedMem* insconfigmem =
       reinterpret_cast<const INSCONFIG_FixedMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  insconfig.reset(new novatel_oem7_msgs::INSCONFIG);
-
-  insconfig->imu_type                         = insconfigmem->imu_type;
-  insconfig->mapping                          = insconfigmem->mapping;
-  insconfig->initial_alignment_velocity       = insconfigmem->initial_alignment_velocity;
-  insconfig->heave_window                     = insconfigmem->heave_window;
-  insconfig->profile                          = insconfigmem->profile;
-
-  std::copy(
-      insconfigmem->enabled_updates,
-      insconfigmem->enabled_updates + arr_size(insconfigmem->enabled_updates),
-      insconfig->enabled_updates.begin());
-
-  insconfig->alignment_mode.mode              = insconfigmem->alignment_mode;
-  insconfig->relative_ins_output_frame.frame  = insconfigmem->relative_ins_output_frame;
-  insconfig->relative_ins_output_direction   = insconfigmem->relative_ins_output_direction;
-
-  std::copy(
-      insconfigmem->ins_receiver_status,
-      insconfigmem->ins_receiver_status + arr_size(insconfigmem->ins_receiver_status),
-      insconfig->ins_receiver_status.status.begin());
-
-  insconfig->ins_seed_enabled                 = insconfigmem->ins_seed_enabled;
-  insconfig->ins_seed_validation              = insconfigmem->ins_seed_validation;
-  insconfig->reserved_1 = insconfigmem->reserved_1;
-  insconfig->reserved_2 = insconfigmem->reserved_2;
-  insconfig->reserved_3 = insconfigmem->reserved_3;
-  insconfig->reserved_4 = insconfigmem->reserved_4;
-  insconfig->reserved_5 = insconfigmem->reserved_5;
-  insconfig->reserved_6 = insconfigmem->reserved_6;
-  insconfig->reserved_7 = insconfigmem->reserved_7;
-
-  insconfig->translations.reserve(Get_INSCONFIG_NumTranslations(insconfigmem));
+
+  insconfig->number_of_translations = Get_INSCONFIG_NumTranslations(insconfigmem);
+  insconfig->translations.resize(insconfig->number_of_translations);
   for(size_t idx = 0;
-             idx < Get_INSCONFIG_NumTranslations(insconfigmem);
+             idx < insconfig->translations.size();
              idx++)
   {
-    const INSCONFIG_TranslationMem* trmem = Get_INSCONFIG_Translation(insconfigmem, idx);
-    novatel_oem7_msgs::Translation& tr = insconfig->translations[idx];
-
-    tr.translation.type    = trmem->translation;
-    tr.frame.frame         = trmem->frame;
-    tr.x_offset            = trmem->x_offset;
-    tr.y_offset            = trmem->y_offset;
-    tr.z_offset            = trmem->z_offset;
-    tr.x_uncertainty       = trmem->x_uncertainty;
-    tr.y_uncertainty       = trmem->y_uncertainty;
-    tr.z_uncertainty       = trmem->z_uncertainty;
-    tr.translation_source.status  = trmem->translation_source;
+    CopyOem7Fields(*Get_INSCONFIG_Translation(insconfigmem, idx), insconfig->translations[idx]);
   }
 
-  insconfig->rotations.reserve(Get_INSCONFIG_NumRotations(insconfigmem));
+  insconfig->number_of_rotations = Get_INSCONFIG_NumRotations(insconfigmem);
+  insconfig->rotations.resize(insconfig->number_of_rotations);
   for(size_t idx = 0;
-             idx < Get_INSCONFIG_NumRotations(insconfigmem);
+             idx < insconfig->rotations.size();
              idx++)
   {
-    const INSCONFIG_RotationMem* rtmem = Get_INSCONFIG_Rotation(insconfigmem, idx);
-    novatel_oem7_msgs::Rotation& rt = insconfig->rotations[idx];
-    rt.rotation.offset         = rtmem->rotation;
-    rt.frame.frame             = rtmem->frame;
-    rt.x_rotation              = rtmem->x_rotation;
-    rt.y_rotation              = rtmem->y_rotation;
-    rt.z_rotation              = rtmem->z_rotation;
-    rt.x_rotation_stdev        = rtmem->x_rotation_stdev;
-    rt.y_rotation_stdev        = rtmem->y_rotation_stdev;
-    rt.z_rotation_stdev        = rtmem->z_rotation_stdev;
-    rt.rotation_source.status  = rtmem->rotation_source;
+    CopyOem7Fields(*Get_INSCONFIG_Rotation(insconfigmem, idx), insconfig->rotations[idx]);
   }
-
-  static const std::string name = "INSCONFIG";
-  SetOem7Header(msg, name, insconfig->nov_header);
 }
 
-
-template<>
+/**
+ * Extracts a bit field from each of 'n' channel tracking status words.
+ * Branch-free over contiguous input, so that the compiler vectorizes it.
+ */
+template <int SHIFT, uint32_t MASK>
 void
-MakeROSMessage<novatel_oem7_msgs::INSPVAX>(
-    const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::INSPVAX>& inspvax)
+UnpackChTrStatusField(const uint32_t* ch_tr_status, size_t n, std::vector<uint8_t>& field)
 {
-  assert(msg->getMessageId() == INSPVAX_OEM7_MSGID);
-
-  const INSPVAXMem* mem = reinterpret_cast<const INSPVAXMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  inspvax.reset(new novatel_oem7_msgs::INSPVAX);
-
-  inspvax->ins_status.status        = mem->ins_status;
-  inspvax->pos_type.type            = mem->pos_type;
-  inspvax->latitude                 = mem->latitude;
-  inspvax->longitude                = mem->longitude;
-  inspvax->height                   = mem->height;
-  inspvax->undulation               = mem->undulation;
-  inspvax->north_velocity           = mem->north_velocity;
-  inspvax->east_velocity            = mem->east_velocity;
-  inspvax->up_velocity              = mem->up_velocity;
-  inspvax->roll                     = mem->roll;
-  inspvax->pitch                    = mem->pitch;
-  inspvax->azimuth                  = mem->azimuth;
-  inspvax->latitude_stdev           = mem->latitude_stdev;
-  inspvax->longitude_stdev          = mem->longitude_stdev;
-  inspvax->height_stdev             = mem->height_stdev;
-  inspvax->north_velocity_stdev     = mem->north_velocity_stdev;
-  inspvax->east_velocity_stdev      = mem->east_velocity_stdev;
-  inspvax->up_velocity_stdev        = mem->up_velocity_stdev;
-  inspvax->roll_stdev               = mem->roll_stdev;
-  inspvax->pitch_stdev              = mem->pitch_stdev;
-  inspvax->azimuth_stdev            = mem->azimuth_stdev;
-  inspvax->ext_sol_status.status    = mem->extended_status;
-
-  static const std::string name = "INSPVAX";
-  SetOem7Header(msg, name, inspvax->nov_header);
+  field.resize(n);
+  uint8_t* out = field.data();
+  for(size_t i = 0; i < n; i++)
+  {
+    out[i] = static_cast<uint8_t>((ch_tr_status[i] >> SHIFT) & MASK);
+  }
 }
 
-
-
 template<>
 void
-MakeROSMessage<novatel_oem7_msgs::INSSTDEV>(
+MakeROSMessage<novatel_oem7_msgs::RANGE>(
     const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::INSSTDEV>& insstdev)
+    boost::shared_ptr<novatel_oem7_msgs::RANGE>& range)
 {
-  assert(msg->getMessageId() == INSSTDEV_OEM7_MSGID);
-
-  const INSSTDEVMem* raw = reinterpret_cast<const INSSTDEVMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  insstdev.reset(new novatel_oem7_msgs::INSSTDEV);
-
-  insstdev->latitude_stdev         = raw->latitude_stdev;
-  insstdev->longitude_stdev        = raw->longitude_stdev;
-  insstdev->height_stdev           = raw->height_stdev;
-  insstdev->north_velocity_stdev   = raw->north_velocity_stdev;
-  insstdev->east_velocity_stdev    = raw->east_velocity_stdev;
-  insstdev->up_velocity_stdev      = raw->up_velocity_stdev;
-  insstdev->roll_stdev             = raw->roll_stdev;
-  insstdev->pitch_stdev            = raw->pitch_stdev;
-  insstdev->azimuth_stdev          = raw->azimuth_stdev;
-  insstdev->ext_sol_status.status  = raw->ext_sol_status;
-  insstdev->time_since_last_update = raw->time_since_last_update;
-  insstdev->reserved1              = raw->reserved1;
-  insstdev->reserved2              = raw->reserved2;
-  insstdev->reserved3              = raw->reserved3;
-
-  static const std::string name = "INSSTDEV";
-  SetOem7Header(msg, name, insstdev->nov_header);
-}
+  assert(msg->getMessageId() == RANGE_OEM7_MSGID);
 
-template<>
-void
-MakeROSMessage<novatel_oem7_msgs::CORRIMU>(
-    const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::CORRIMU>& corrimu)
-{
-  corrimu.reset(new novatel_oem7_msgs::CORRIMU);
+  const RANGE_FixedMem* mem = reinterpret_cast<const RANGE_FixedMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
+  range = AllocROSMessage<novatel_oem7_msgs::RANGE>();
 
-  if(msg->getMessageId() == CORRIMUS_OEM7_MSGID)
-  {
-    const CORRIMUSMem* raw = reinterpret_cast<const CORRIMUSMem*>(msg->getMessageData(OEM7_BINARY_MSG_SHORT_HDR_LEN));
-    corrimu->imu_data_count   = raw->imu_data_count;
-    corrimu->pitch_rate       = raw->pitch_rate;
-    corrimu->roll_rate        = raw->roll_rate;
-    corrimu->yaw_rate         = raw->yaw_rate;
-    corrimu->lateral_acc      = raw->lateral_acc;
-    corrimu->longitudinal_acc = raw->longitudinal_acc;
-    corrimu->vertical_acc     = raw->vertical_acc;
-  }
-  else if(msg->getMessageId() == IMURATECORRIMUS_OEM7_MSGID)
+  // Observations present in the message, regardless of the declared count.
+  const size_t max_obs = msg->getMessageDataLength() > OEM7_BINARY_MSG_HDR_LEN + sizeof(RANGE_FixedMem) ?
+      (msg->getMessageDataLength() - OEM7_BINARY_MSG_HDR_LEN - sizeof(RANGE_FixedMem)) / sizeof(RANGE_ObservationMem) : 0;
+  size_t num_obs = Get_RANGE_NumObservations(mem);
+  if(num_obs > max_obs)
   {
-    const IMURATECORRIMUSMem* raw =
-        reinterpret_cast<const IMURATECORRIMUSMem*>(msg->getMessageData(OEM7_BINARY_MSG_SHORT_HDR_LEN));
-    corrimu->imu_data_count   = 0; // FIXME
-    corrimu->pitch_rate       = raw->pitch_rate;
-    corrimu->roll_rate        = raw->roll_rate;
-    corrimu->yaw_rate         = raw->yaw_rate;
-    corrimu->lateral_acc      = raw->lateral_acc;
-    corrimu->longitudinal_acc = raw->longitudinal_acc;
-    corrimu->vertical_acc     = raw->vertical_acc;
+    ROS_ERROR_STREAM("RANGE: " << num_obs << " observations declared; " << max_obs << " present.");
+    num_obs = max_obs;
   }
-  else
+
+  range->num_obs = num_obs;
+  range->prn.resize(         num_obs);
+  range->glofreq.resize(     num_obs);
+  range->psr.resize(         num_obs);
+  range->psr_stdev.resize(   num_obs);
+  range->adr.resize(         num_obs);
+  range->adr_stdev.resize(   num_obs);
+  range->dopp.resize(        num_obs);
+  range->cno.resize(         num_obs);
+  range->locktime.resize(    num_obs);
+  range->ch_tr_status.resize(num_obs);
+
+  for(size_t idx = 0; idx < num_obs; idx++)
   {
-    assert(false);
+    const RANGE_ObservationMem* obs = Get_RANGE_Observation(mem, idx);
+
+    range->prn[idx]          = obs->prn;
+    range->glofreq[idx]      = obs->glofreq;
+    range->psr[idx]          = obs->psr;
+    range->psr_stdev[idx]    = obs->psr_std;
+    range->adr[idx]          = obs->adr;
+    range->adr_stdev[idx]    = obs->adr_std;
+    range->dopp[idx]         = obs->dopp;
+    range->cno[idx]          = obs->cno;
+    range->locktime[idx]     = obs->locktime;
+    range->ch_tr_status[idx] = obs->ch_tr_status;
   }
 
-  static const std::string name = "CORRIMU";
-  SetOem7ShortHeader(msg, name, corrimu->nov_header);
-}
-
-template<>
-void
-MakeROSMessage<novatel_oem7_msgs::TIME>(
-    const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::TIME>& time)
-{
-  assert(msg->getMessageId()== TIME_OEM7_MSGID);
-
-  const TIMEMem* mem = reinterpret_cast<const TIMEMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  time.reset(new novatel_oem7_msgs::TIME);
-
-  time->clock_status  = mem->clock_status;
-  time->offset        = mem->offset;
-  time->offset_std    = mem->offset_std;
-  time->utc_offset    = mem->utc_offset;
-  time->utc_year      = mem->utc_year;
-  time->utc_month     = mem->utc_month;
-  time->utc_day       = mem->utc_day;
-  time->utc_hour      = mem->utc_hour;
-  time->utc_min       = mem->utc_min;
-  time->utc_msec      = mem->utc_msec;
-  time->utc_status    = mem->utc_status;
-
-  static const std::string name = "TIME";
-  SetOem7Header(msg, name, time->nov_header);
+  // Channel tracking status; refer to Oem7 manual, RANGE log.
+  const uint32_t* status = range->ch_tr_status.data();
+  UnpackChTrStatusField< 0, 0x1F>(status, num_obs, range->tracking_state);
+  UnpackChTrStatusField< 5, 0x1F>(status, num_obs, range->sv_channel);
+  UnpackChTrStatusField<10, 0x01>(status, num_obs, range->phase_lock);
+  UnpackChTrStatusField<11, 0x01>(status, num_obs, range->parity_known);
+  UnpackChTrStatusField<12, 0x01>(status, num_obs, range->code_lock);
+  UnpackChTrStatusField<13, 0x07>(status, num_obs, range->correlator_type);
+  UnpackChTrStatusField<16, 0x07>(status, num_obs, range->satellite_system);
+  UnpackChTrStatusField<20, 0x01>(status, num_obs, range->grouped);
+  UnpackChTrStatusField<21, 0x1F>(status, num_obs, range->signal_type);
+  UnpackChTrStatusField<27, 0x01>(status, num_obs, range->primary_l1);
+  UnpackChTrStatusField<28, 0x01>(status, num_obs, range->half_cycle_added);
+  UnpackChTrStatusField<29, 0x01>(status, num_obs, range->digital_filtering);
+  UnpackChTrStatusField<30, 0x01>(status, num_obs, range->prn_lock);
+  UnpackChTrStatusField<31, 0x01>(status, num_obs, range->channel_assignment_forced);
+
+  static const std::string name = "RANGE";
+  SetOem7Header(msg, name, range->nov_header);
 }
 
-template<>
-void
-MakeROSMessage<novatel_oem7_msgs::RXSTATUS>(
-    const Oem7RawMessageIf::ConstPtr& msg,
-    boost::shared_ptr<novatel_oem7_msgs::RXSTATUS>& rxstatus)
-{
-  assert(msg->getMessageId() == RXSTATUS_OEM7_MSGID);
-
-  const RXSTATUSMem* mem = reinterpret_cast<const RXSTATUSMem*>(msg->getMessageData(OEM7_BINARY_MSG_HDR_LEN));
-  rxstatus.reset(new novatel_oem7_msgs::RXSTATUS);
-
-  rxstatus->error              = mem->error;
-  rxstatus->num_status_codes   = mem->num_status_codes;
-  rxstatus->rxstat             = mem->rxstat;
-  rxstatus->rxstat_pri_mask    = mem->rxstat_pri_mask;
-  rxstatus->rxstat_set_mask    = mem->rxstat_set_mask;
-  rxstatus->rxstat_clr_mask    = mem->rxstat_clr_mask;
-  rxstatus->aux1_stat          = mem->aux1_stat;
-  rxstatus->aux1_stat_pri      = mem->aux1_stat_pri;
-  rxstatus->aux1_stat_set      = mem->aux1_stat_set;
-  rxstatus->aux1_stat_clr      = mem->aux1_stat_clr;
-  rxstatus->aux2_stat          = mem->aux2_stat;
-  rxstatus->aux2_stat_pri      = mem->aux2_stat_pri;
-  rxstatus->aux2_stat_set      = mem->aux2_stat_set;
-  rxstatus->aux2_stat_clr      = mem->aux2_stat_clr;
-  rxstatus->aux3_stat          = mem->aux3_stat;
-  rxstatus->aux3_stat_pri      = mem->aux3_stat_pri;
-  rxstatus->aux3_stat_set      = mem->aux3_stat_set;
-  rxstatus->aux3_stat_clr      = mem->aux3_stat_clr;
-  rxstatus->aux4_stat          = mem->aux4_stat;
-  rxstatus->aux4_stat_pri      = mem->aux4_stat_pri;
-  rxstatus->aux4_stat_set      = mem->aux4_stat_set;
-  rxstatus->aux4_stat_clr      = mem->aux4_stat_clr;
-
-
-  static const std::string name = "RXSTATUS";
-  SetOem7Header(msg, name, rxstatus->nov_header);
-};
-
 
 template
 void
@@ -539,6 +570,10 @@ template
 void
 MakeROSMessage(const Oem7RawMessageIf::ConstPtr&,  boost::shared_ptr<novatel_oem7_msgs::INSCONFIG>&);
 
+template
+void
+MakeROSMessage(const Oem7RawMessageIf::ConstPtr&,  boost::shared_ptr<novatel_oem7_msgs::HEADING2>&);
+
 template
 void
 MakeROSMessage(const Oem7RawMessageIf::ConstPtr&,  boost::shared_ptr<novatel_oem7_msgs::INSSTDEV>&);
@@ -555,6 +590,10 @@ template
 void
 MakeROSMessage(const Oem7RawMessageIf::ConstPtr&,  boost::shared_ptr<novatel_oem7_msgs::RXSTATUS>&);
 
+template
+void
+MakeROSMessage(const Oem7RawMessageIf::ConstPtr&,  boost::shared_ptr<novatel_oem7_msgs::RANGE>&);
+
 
 //---------------------------------------------------------------------------------------------------------------
 /***
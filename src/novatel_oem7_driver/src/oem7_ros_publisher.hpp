@@ -26,7 +26,16 @@
 #define __OEM7_ROS_PUBLISHER_HPP__
 
 
+#include <atomic>
+#include <algorithm>
+
+#include <boost/shared_ptr.hpp>
+
 #include <novatel_oem7_driver/ros_messages.hpp>
+#include <oem7_latency.hpp>
+#include <oem7_message_context.hpp>
+#include <oem7_shm_publisher.hpp>
+#include <oem7_param_cache.hpp>
 
 
 namespace novatel_oem7_driver
@@ -34,6 +43,12 @@ namespace novatel_oem7_driver
 
 /**
  * Encapsulates ROS message publisher, configured and enabled based on ROS parameters.
+ *
+ * Topics are prefixed with 'oem7_topic_prefix', if set; e.g. to separate the topics of several receivers.
+ * Topics configured with 'prefixed: "false"' are not, e.g. /diagnostics.
+ *
+ * Topics configured with 'shm: "true"' are also written to a shared memory ring, for consumers on the same host;
+ * 'shm_slots' sets the ring size. See oem7_shm_ring.hpp.
  */
 class Oem7RosPublisher
 {
@@ -41,15 +56,31 @@ class Oem7RosPublisher
 
   std::string frame_id_; ///< Configurable frame ID.
 
+  std::atomic<uint32_t> seq_; ///< Sequence number of the last message published; per publisher, so uncontended.
+
+  bool null_; ///< Enabled, but messages are dropped instead of published; see setup().
+
+  boost::shared_ptr<Oem7ShmPublisherIf> shm_pub_; ///< Optional shared memory ring.
+
 public:
+  Oem7RosPublisher():
+    seq_(0),
+    null_(false)
+  {
+  }
 
+  /**
+   * Sets up publishing of message 'name', as configured in nh.
+   * With 'oem7_null_publishing' set in nh, the topic is not advertised; messages are built and stamped as usual,
+   * then dropped. For benchmarks, which measure the cost of producing messages, without ROS transport.
+   */
   template<typename M>
   void setup(const std::string& name, ros::NodeHandle& nh)
   {
     typedef std::map<std::string, std::string> message_config_map_t;
 
     message_config_map_t message_config_map;
-    nh.getParam(name, message_config_map);
+    getOem7Param(nh, name, message_config_map);
 
     message_config_map_t::iterator topic_itr = message_config_map.find("topic");
     if(topic_itr == message_config_map.end())
@@ -73,8 +104,45 @@ public:
       frame_id_ = frame_id_itr->second;
     }
 
-    ROS_INFO_STREAM("topic [" << topic_itr->second << "]: frame_id: '" << frame_id_ << "'; q size: " << queue_size);
-    ros_pub_ = nh.advertise<M>(topic_itr->second, queue_size);
+    std::string topic = topic_itr->second;
+
+    message_config_map_t::iterator prefixed_itr = message_config_map.find("prefixed");
+    if(prefixed_itr == message_config_map.end() || prefixed_itr->second != "false")
+    {
+      std::string topic_prefix;
+      getOem7Param(nh, "oem7_topic_prefix", topic_prefix);
+      if(!topic_prefix.empty())
+      {
+        topic = topic_prefix + (topic[0] == '/' ? "" : "/") + topic;
+      }
+    }
+
+    bool null_publishing = false;
+    getOem7Param(nh, "oem7_null_publishing", null_publishing);
+    if(null_publishing)
+    {
+      ROS_INFO_STREAM("topic [" << topic << "]: frame_id: '" << frame_id_ << "'; not advertised, null publisher.");
+      null_ = true;
+      return;
+    }
+
+    ROS_INFO_STREAM("topic [" << topic << "]: frame_id: '" << frame_id_ << "'; q size: " << queue_size);
+    ros_pub_ = nh.advertise<M>(topic, queue_size);
+
+    message_config_map_t::iterator shm_itr = message_config_map.find("shm");
+    if(shm_itr != message_config_map.end() && shm_itr->second == "true")
+    {
+      int shm_slots = 64; // default size
+
+      message_config_map_t::iterator shm_slots_itr = message_config_map.find("shm_slots");
+      if(shm_slots_itr != message_config_map.end())
+      {
+        std::stringstream ss(shm_slots_itr->second);
+        ss >> shm_slots;
+      }
+
+      shm_pub_.reset(makeOem7ShmPublisher<M>(topic, std::max(shm_slots, 1)));
+    }
   }
 
   /**
@@ -82,11 +150,12 @@ public:
    */
   bool isEnabled()
   {
-    return !ros_pub_.getTopic().empty();
+    return null_ || !ros_pub_.getTopic().empty();
   }
 
   /**
    * Publish a message on this publisher. The message is ignored when the publisher is disabled.
+   * The message is stamped with the arrival time of the raw message it is derived from, see Oem7MessageContext.
    */
   template <typename M>
   void publish(boost::shared_ptr<M>& msg)
@@ -96,8 +165,20 @@ public:
       return;
     }
 
-    SetROSHeader(frame_id_, msg);
-    ros_pub_.publish(msg);
+    OEM7_LATENCY_CONVERTED(convert_ns);
+
+    SetROSHeader(frame_id_, Oem7MessageContext::current().getStamp(), ++seq_, msg);
+    if(!null_)
+    {
+      ros_pub_.publish(msg);
+
+      if(shm_pub_)
+      {
+        shm_pub_->publish(msg.get());
+      }
+    }
+
+    OEM7_LATENCY_PUBLISHED(convert_ns);
   }
 
 };
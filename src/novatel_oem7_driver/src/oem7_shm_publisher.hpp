@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __OEM7_SHM_PUBLISHER_HPP__
+#define __OEM7_SHM_PUBLISHER_HPP__
+
+#include <ros/ros.h>
+
+#include <novatel_oem7_driver/oem7_shm_ring.hpp>
+
+#include "novatel_oem7_msgs/BESTPOS.h"
+#include "novatel_oem7_msgs/INSPVA.h"
+#include "novatel_oem7_msgs/CORRIMU.h"
+#include "sensor_msgs/Imu.h"
+
+#include <type_traits>
+#include <cerrno>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Shared memory layout of ROS message M; specialized for supported messages.
+   */
+  template <typename M>
+  struct Oem7ShmTraits
+  {
+    static const bool SUPPORTED = false;
+  };
+
+  inline void SetShmHeader(const std_msgs::Header& ros_hdr, Oem7ShmHeader& hdr)
+  {
+    hdr.seq        = ros_hdr.seq;
+    hdr.stamp_sec  = ros_hdr.stamp.sec;
+    hdr.stamp_nsec = ros_hdr.stamp.nsec;
+    std::strncpy(hdr.frame_id, ros_hdr.frame_id.c_str(), sizeof(hdr.frame_id) - 1);
+  }
+
+  inline void SetShmHeader(const novatel_oem7_msgs::Oem7Header& nov_hdr, Oem7ShmHeader& hdr)
+  {
+    hdr.gps_week_number       = nov_hdr.gps_week_number;
+    hdr.time_status           = nov_hdr.time_status;
+    hdr.gps_week_milliseconds = nov_hdr.gps_week_milliseconds;
+  }
+
+  template <>
+  struct Oem7ShmTraits<novatel_oem7_msgs::BESTPOS>
+  {
+    static const bool SUPPORTED = true;
+    typedef Oem7ShmBESTPOS Layout;
+
+    static void convert(const novatel_oem7_msgs::BESTPOS& msg, Layout& shm)
+    {
+      SetShmHeader(msg.nov_header, shm.header);
+      shm.sol_status              = msg.sol_status.status;
+      shm.pos_type                = msg.pos_type.type;
+      shm.lat                     = msg.lat;
+      shm.lon                     = msg.lon;
+      shm.hgt                     = msg.hgt;
+      shm.undulation              = msg.undulation;
+      shm.datum_id                = msg.datum_id;
+      shm.lat_stdev               = msg.lat_stdev;
+      shm.lon_stdev               = msg.lon_stdev;
+      shm.hgt_stdev               = msg.hgt_stdev;
+      shm.diff_age                = msg.diff_age;
+      shm.sol_age                 = msg.sol_age;
+      shm.num_svs                 = msg.num_svs;
+      shm.num_sol_svs             = msg.num_sol_svs;
+      shm.num_sol_l1_svs          = msg.num_sol_l1_svs;
+      shm.num_sol_multi_svs       = msg.num_sol_multi_svs;
+      shm.ext_sol_stat            = msg.ext_sol_stat.status;
+      shm.galileo_beidou_sig_mask = msg.galileo_beidou_sig_mask;
+      shm.gps_glonass_sig_mask    = msg.gps_glonass_sig_mask;
+    }
+  };
+
+  template <>
+  struct Oem7ShmTraits<novatel_oem7_msgs::INSPVA>
+  {
+    static const bool SUPPORTED = true;
+    typedef Oem7ShmINSPVA Layout;
+
+    static void convert(const novatel_oem7_msgs::INSPVA& msg, Layout& shm)
+    {
+      SetShmHeader(msg.nov_header, shm.header);
+      shm.latitude       = msg.latitude;
+      shm.longitude      = msg.longitude;
+      shm.height         = msg.height;
+      shm.north_velocity = msg.north_velocity;
+      shm.east_velocity  = msg.east_velocity;
+      shm.up_velocity    = msg.up_velocity;
+      shm.roll           = msg.roll;
+      shm.pitch          = msg.pitch;
+      shm.azimuth        = msg.azimuth;
+      shm.status         = msg.status.status;
+    }
+  };
+
+  template <>
+  struct Oem7ShmTraits<novatel_oem7_msgs::CORRIMU>
+  {
+    static const bool SUPPORTED = true;
+    typedef Oem7ShmCORRIMU Layout;
+
+    static void convert(const novatel_oem7_msgs::CORRIMU& msg, Layout& shm)
+    {
+      SetShmHeader(msg.nov_header, shm.header);
+      shm.imu_data_count   = msg.imu_data_count;
+      shm.pitch_rate       = msg.pitch_rate;
+      shm.roll_rate        = msg.roll_rate;
+      shm.yaw_rate         = msg.yaw_rate;
+      shm.lateral_acc      = msg.lateral_acc;
+      shm.longitudinal_acc = msg.longitudinal_acc;
+      shm.vertical_acc     = msg.vertical_acc;
+    }
+  };
+
+  template <>
+  struct Oem7ShmTraits<sensor_msgs::Imu>
+  {
+    static const bool SUPPORTED = true;
+    typedef Oem7ShmImu Layout;
+
+    static void convert(const sensor_msgs::Imu& msg, Layout& shm)
+    {
+      shm.orientation[0] = msg.orientation.x;
+      shm.orientation[1] = msg.orientation.y;
+      shm.orientation[2] = msg.orientation.z;
+      shm.orientation[3] = msg.orientation.w;
+
+      shm.angular_velocity[0] = msg.angular_velocity.x;
+      shm.angular_velocity[1] = msg.angular_velocity.y;
+      shm.angular_velocity[2] = msg.angular_velocity.z;
+
+      shm.linear_acceleration[0] = msg.linear_acceleration.x;
+      shm.linear_acceleration[1] = msg.linear_acceleration.y;
+      shm.linear_acceleration[2] = msg.linear_acceleration.z;
+
+      for(int i = 0; i < 9; i++)
+      {
+        shm.orientation_covariance[i]         = msg.orientation_covariance[i];
+        shm.angular_velocity_covariance[i]    = msg.angular_velocity_covariance[i];
+        shm.linear_acceleration_covariance[i] = msg.linear_acceleration_covariance[i];
+      }
+    }
+  };
+
+
+  /**
+   * Writes ROS messages to a shared memory ring, alongside the ROS publisher.
+   */
+  class Oem7ShmPublisherIf
+  {
+  public:
+    virtual ~Oem7ShmPublisherIf()
+    {
+    }
+
+    /**
+     * @param msg ROS message, of the type the publisher was made for; stamped.
+     */
+    virtual void publish(const void* msg) = 0;
+  };
+
+  template <typename M>
+  class Oem7ShmPublisher: public Oem7ShmPublisherIf
+  {
+    typedef typename Oem7ShmTraits<M>::Layout Layout;
+
+    Oem7ShmRingWriter ring_;
+
+  public:
+    bool create(const std::string& name, size_t num_slots)
+    {
+      return ring_.create(name, Layout::type(), sizeof(Layout), num_slots);
+    }
+
+    virtual void publish(const void* msg)
+    {
+      const M& ros_msg = *static_cast<const M*>(msg);
+
+      Layout shm;
+      std::memset(&shm, 0, sizeof(shm));
+      SetShmHeader(ros_msg.header, shm.header);
+      Oem7ShmTraits<M>::convert(ros_msg, shm);
+
+      ring_.write(&shm);
+    }
+  };
+
+  /**
+   * Creates the shared memory ring for a topic; see getOem7ShmName().
+   * @return NULL if message M has no shared memory layout, or the ring cannot be created.
+   */
+  template <typename M>
+  typename std::enable_if<Oem7ShmTraits<M>::SUPPORTED, Oem7ShmPublisherIf*>::type
+  makeOem7ShmPublisher(const std::string& topic, size_t num_slots)
+  {
+    const std::string name = getOem7ShmName(topic);
+
+    Oem7ShmPublisher<M>* pub = new Oem7ShmPublisher<M>;
+    if(!pub->create(name, num_slots))
+    {
+      if(errno == EEXIST)
+      {
+        ROS_ERROR_STREAM("topic [" << topic << "]: shared memory '" << name << "' is written by another live process; "
+                                   "not written to shared memory.");
+      }
+      else
+      {
+        ROS_ERROR_STREAM("topic [" << topic << "]: cannot create shared memory '" << name << "': " << strerror(errno));
+      }
+      delete pub;
+      return NULL;
+    }
+
+    ROS_INFO_STREAM("topic [" << topic << "]: shared memory: '" << name << "'; slots: " << num_slots);
+    return pub;
+  }
+
+  template <typename M>
+  typename std::enable_if<!Oem7ShmTraits<M>::SUPPORTED, Oem7ShmPublisherIf*>::type
+  makeOem7ShmPublisher(const std::string& topic, size_t)
+  {
+    ROS_WARN_STREAM("topic [" << topic << "]: no shared memory layout for this message; not written to shared memory.");
+    return NULL;
+  }
+}
+
+#endif
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __OEM7_STARTUP_HPP__
+#define __OEM7_STARTUP_HPP__
+
+#include <ros/ros.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <sstream>
+
+#include <pluginlib/class_loader.h>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Serializes plugin instantiation; plugins are initialized concurrently, but pluginlib is not documented thread safe.
+   */
+  inline std::mutex& getOem7PluginMutex()
+  {
+    static std::mutex plugin_mtx;
+    return plugin_mtx;
+  }
+
+  /**
+   * Instantiates a plugin; safe to call concurrently.
+   */
+  template <typename T>
+  boost::shared_ptr<T> createOem7Plugin(pluginlib::ClassLoader<T>& loader, const std::string& name)
+  {
+    std::lock_guard<std::mutex> lk(getOem7PluginMutex());
+    return loader.createInstance(name);
+  }
+
+  /**
+   * Signals that a number of threads are ready.
+   */
+  class Oem7ReadinessLatch
+  {
+    std::mutex              mtx_;
+    std::condition_variable ready_cond_;
+    size_t                  num_pending_;
+
+  public:
+    Oem7ReadinessLatch():
+      num_pending_(0)
+    {
+    }
+
+    /**
+     * Expects 'num' more threads to become ready.
+     */
+    void expect(size_t num)
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      num_pending_ += num;
+    }
+
+    /**
+     * Called by a thread once it is ready.
+     */
+    void ready()
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      if(num_pending_ > 0 && --num_pending_ == 0)
+      {
+        ready_cond_.notify_all();
+      }
+    }
+
+    /**
+     * Waits for all expected threads to become ready.
+     * @return false on timeout.
+     */
+    bool wait(double timeout_sec)
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+      return ready_cond_.wait_for(lk, std::chrono::duration<double>(timeout_sec), [this](){ return num_pending_ == 0; });
+    }
+  };
+
+  /**
+   * Measures startup phases, for a startup time breakdown.
+   */
+  class Oem7StartupTimer
+  {
+    const ros::WallTime start_;
+    ros::WallTime       phase_start_;
+    std::stringstream   breakdown_;
+
+  public:
+    Oem7StartupTimer():
+      start_(ros::WallTime::now()),
+      phase_start_(start_)
+    {
+    }
+
+    /**
+     * Ends the current phase, and starts the next one.
+     */
+    void endPhase(const std::string& phase)
+    {
+      const ros::WallTime now = ros::WallTime::now();
+      breakdown_ << phase << ": " << static_cast<int>((now - phase_start_).toSec() * 1000.0) << " ms; ";
+      phase_start_ = now;
+    }
+
+    /**
+     * @return phases so far, and the total
+     */
+    std::string getBreakdown() const
+    {
+      return breakdown_.str() + "total: " +
+                std::to_string(static_cast<int>((ros::WallTime::now() - start_).toSec() * 1000.0)) + " ms";
+    }
+  };
+}
+
+#endif
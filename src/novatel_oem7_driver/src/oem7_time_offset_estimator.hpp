@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __OEM7_TIME_OFFSET_ESTIMATOR_HPP__
+#define __OEM7_TIME_OFFSET_ESTIMATOR_HPP__
+
+#include <deque>
+#include <cmath>
+#include <algorithm>
+#include <stdint.h>
+
+
+namespace novatel_oem7_driver
+{
+
+/**
+ * Online estimator of the offset and drift between receiver time and host time, in seconds.
+ *
+ * Each sample pairs the receiver time of a message with its arrival time on the host; the difference is the clock
+ * offset plus a transport delay, which is never negative and varies with host load.
+ * A sliding window over receiver time is divided into buckets, and only the sample with the smallest difference
+ * is kept in each: a minimum filter, which rejects the delays added by queueing.
+ * Offset and drift are the least-squares line through the bucket minima.
+ *
+ * Host times mapped from receiver time therefore include the smallest transport delay, but none of the jitter.
+ */
+class Oem7TimeOffsetEstimator
+{
+  struct Bucket
+  {
+    int64_t index;  ///< Bucket number: receiver time / bucket width
+    double  rcvr_t; ///< Receiver time of the minimum sample
+    double  diff;   ///< Minimum host - receiver time in the bucket
+  };
+
+  double bucket_width_;  ///< seconds
+  size_t num_buckets_;   ///< Buckets in the window
+  double max_step_;      ///< Larger decreases in the offset restart estimation; seconds.
+
+  std::deque<Bucket> buckets_; ///< Oldest first
+
+  // Current estimate: host_t = rcvr_t + offset_ + drift_ * (rcvr_t - ref_t_)
+  double ref_t_;
+  double offset_;
+  double drift_;
+
+  /**
+   * Fits offset and drift to the minima of complete buckets; the newest bucket is still filling,
+   * unless it is the only one.
+   */
+  void fit()
+  {
+    const std::deque<Bucket>::const_iterator end = buckets_.size() > 1 ? buckets_.end() - 1 : buckets_.end();
+    const size_t num_complete = end - buckets_.begin();
+
+    ref_t_  = (end - 1)->rcvr_t;
+    offset_ = (end - 1)->diff;
+    drift_  = 0.0;
+
+    if(num_complete < 3) // Not enough for a drift estimate that is better than none.
+    {
+      for(std::deque<Bucket>::const_iterator b = buckets_.begin(); b != end; ++b)
+      {
+        offset_ = std::min(offset_, b->diff);
+      }
+      return;
+    }
+
+    // Centered on the newest complete bucket, to keep precision with large absolute times.
+    double sum_t = 0.0, sum_d = 0.0;
+    for(std::deque<Bucket>::const_iterator b = buckets_.begin(); b != end; ++b)
+    {
+      sum_t += b->rcvr_t - ref_t_;
+      sum_d += b->diff   - offset_;
+    }
+    const double mean_t = sum_t / num_complete;
+    const double mean_d = sum_d / num_complete;
+
+    double cov_td = 0.0, var_t = 0.0;
+    for(std::deque<Bucket>::const_iterator b = buckets_.begin(); b != end; ++b)
+    {
+      const double dt = b->rcvr_t - ref_t_  - mean_t;
+      const double dd = b->diff   - offset_ - mean_d;
+      cov_td += dt * dd;
+      var_t  += dt * dt;
+    }
+
+    if(var_t > 0.0)
+    {
+      drift_ = cov_td / var_t;
+    }
+    offset_ += mean_d - drift_ * mean_t;
+  }
+
+public:
+  Oem7TimeOffsetEstimator(
+      double window_sec  = 60.0, ///< Sliding window, receiver time.
+      size_t num_buckets = 10,   ///< Minimum filter buckets in the window; refitted as each bucket completes.
+      double max_step    = 1.0   ///< Offset decrease considered a clock step.
+      ):
+    bucket_width_(window_sec / std::max<size_t>(num_buckets, 1)),
+    num_buckets_(std::max<size_t>(num_buckets, 1)),
+    max_step_(max_step),
+    ref_t_(0.0),
+    offset_(0.0),
+    drift_(0.0)
+  {
+  }
+
+  /**
+   * Restarts estimation.
+   */
+  void reset()
+  {
+    buckets_.clear();
+    ref_t_  = 0.0;
+    offset_ = 0.0;
+    drift_  = 0.0;
+  }
+
+  /**
+   * Adds a sample.
+   */
+  void addSample(
+      double rcvr_t, ///< Receiver time of the message
+      double host_t  ///< Host time of its arrival
+      )
+  {
+    const double  diff  = host_t - rcvr_t;
+    const int64_t index = static_cast<int64_t>(std::floor(rcvr_t / bucket_width_));
+
+    // Receiver time going backwards or jumping past the window, or a sample arriving well before the estimate allows,
+    // i.e. a clock step: start over. Late arrivals are just delays; steps the other way age out of the window.
+    if(!buckets_.empty() &&
+       (index < buckets_.back().index ||
+        index >= buckets_.back().index + static_cast<int64_t>(num_buckets_) ||
+        diff < getOffset(rcvr_t) - max_step_))
+    {
+      reset();
+    }
+
+    if(buckets_.empty() || index > buckets_.back().index)
+    {
+      Bucket b = {index, rcvr_t, diff};
+      buckets_.push_back(b);
+
+      while(buckets_.front().index <= index - static_cast<int64_t>(num_buckets_))
+      {
+        buckets_.pop_front();
+      }
+
+      fit(); // The previous bucket is complete.
+    }
+    else if(diff < buckets_.back().diff)
+    {
+      buckets_.back().rcvr_t = rcvr_t;
+      buckets_.back().diff   = diff;
+
+      if(buckets_.size() == 1)
+      {
+        fit(); // Refine the initial estimate.
+      }
+    }
+  }
+
+  /**
+   * @return true if there is an estimate.
+   */
+  bool isValid() const
+  {
+    return !buckets_.empty();
+  }
+
+  /**
+   * @return host - receiver time at receiver time rcvr_t
+   */
+  double getOffset(double rcvr_t) const
+  {
+    return offset_ + drift_ * (rcvr_t - ref_t_);
+  }
+
+  /**
+   * @return receiver clock drift relative to the host clock, s/s.
+   */
+  double getDrift() const
+  {
+    return drift_;
+  }
+
+  /**
+   * @return host time corresponding to receiver time.
+   */
+  double toHostTime(double rcvr_t) const
+  {
+    return rcvr_t + getOffset(rcvr_t);
+  }
+};
+
+}
+#endif
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <novatel_oem7_driver/oem7_message_handler_if.hpp>
+
+#include <oem7_ros_publisher.hpp>
+
+#include <ros/ros.h>
+
+#include <novatel_oem7_driver/oem7_ros_messages.hpp>
+
+#include "novatel_oem7_msgs/RANGE.h"
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Decodes RANGE observations into novatel_oem7_msgs::RANGE.
+   */
+  class RANGEHandler: public Oem7MessageHandlerIf
+  {
+    Oem7RosPublisher RANGE_pub_;
+
+
+    void publishRANGE(Oem7RawMessageIf::ConstPtr msg)
+    {
+      boost::shared_ptr<novatel_oem7_msgs::RANGE> range;
+      MakeROSMessage(msg, range);
+      RANGE_pub_.publish(range);
+    }
+
+  public:
+    RANGEHandler()
+    {
+    }
+
+    ~RANGEHandler()
+    {
+    }
+
+    void initialize(ros::NodeHandle& nh)
+    {
+      RANGE_pub_.setup<novatel_oem7_msgs::RANGE>("RANGE", nh);
+    }
+
+    const std::vector<int>& getMessageIds()
+    {
+      static const std::vector<int> MSG_IDS({RANGE_OEM7_MSGID});
+      return MSG_IDS;
+    }
+
+    void handleMsg(Oem7RawMessageIf::ConstPtr msg)
+    {
+      if(!RANGE_pub_.isEnabled())
+      {
+        return;
+      }
+
+      publishRANGE(msg);
+    }
+  };
+}
+
+#include <pluginlib/class_list_macros.h>
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::RANGEHandler, novatel_oem7_driver::Oem7MessageHandlerIf)
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <novatel_oem7_driver/oem7_message_handler_if.hpp>
+
+#include <oem7_ros_publisher.hpp>
+#include <oem7_ros_message_pool.hpp>
+#include <oem7_message_context.hpp>
+
+#include <ros/ros.h>
+
+#include <novatel_oem7_driver/oem7_ros_messages.hpp>
+#include <novatel_oem7_driver/oem7_message_util.hpp>
+
+#include "sensor_msgs/Imu.h"
+#include "novatel_oem7_msgs/IMUBatch.h"
+
+#include <algorithm>
+#include <string>
+
+
+namespace novatel_oem7_driver
+{
+  /**
+   * Decodes RAWIMUSX into sensor_msgs::Imu, in the IMU body frame, and optionally into batches of samples,
+   * novatel_oem7_msgs::IMUBatch, which save a message per sample at high IMU rates.
+   *
+   * Raw counts are scaled using the factors of the IMU type in 'supported_imus':
+   *  gyro_scale:  rad / LSB
+   *  accel_scale: m/s / LSB
+   *  raw_rates:   "true" if the counts are rates, i.e. the scales are rad/s / LSB and m/s^2 / LSB;
+   *               otherwise they are increments over one sample, scaled by the IMU rate.
+   */
+  class RAWIMUHandler: public Oem7MessageHandlerIf
+  {
+    ros::NodeHandle nh_;
+
+    Oem7RosPublisher Imu_pub_;
+    Oem7RosPublisher IMUBatch_pub_;
+
+    int imu_type_;       ///< IMU type of the current scale factors; -1: none.
+    bool has_scale_;     ///< Scale factors are known for imu_type_
+    double gyro_scale_;  ///< rad/s / LSB
+    double accel_scale_; ///< m/s^2 / LSB
+
+    size_t batch_size_; ///< Samples per IMUBatch
+    boost::shared_ptr<novatel_oem7_msgs::IMUBatch> batch_;
+
+
+    bool getImuParam(int imu_type, const std::string& name, std::string& param)
+    {
+      std::string ns = ros::this_node::getNamespace();
+      std::string param_name = ns + "/supported_imus/" + std::to_string(imu_type) + "/" + name;
+      return getOem7Param(nh_, param_name, param);
+    }
+
+    /**
+     * Looks up scale factors when the IMU type changes.
+     */
+    void updateScale(int imu_type)
+    {
+      if(imu_type == imu_type_)
+      {
+        return;
+      }
+
+      imu_type_  = imu_type;
+      has_scale_ = false;
+
+      std::string name, rate, gyro_scale, accel_scale, raw_rates;
+      getImuParam(imu_type, "name", name);
+      getImuParam(imu_type, "raw_rates", raw_rates);
+      if(!getImuParam(imu_type, "rate",        rate)       ||
+         !getImuParam(imu_type, "gyro_scale",  gyro_scale) ||
+         !getImuParam(imu_type, "accel_scale", accel_scale))
+      {
+        ROS_ERROR_STREAM("RAWIMU: no scale factors for IMU type= " << imu_type << " '" << name << "'; not decoded.");
+        return;
+      }
+
+      // Increments over a sample: multiply by samples per second.
+      const double scale_rate = raw_rates == "true" ? 1.0 : std::stod(rate);
+
+      gyro_scale_  = std::stod(gyro_scale)  * scale_rate;
+      accel_scale_ = std::stod(accel_scale) * scale_rate;
+      has_scale_   = gyro_scale_ > 0.0 && accel_scale_ > 0.0;
+
+      ROS_LOG_STREAM(has_scale_ ? ::ros::console::levels::Info : ::ros::console::levels::Error,
+                     ROSCONSOLE_DEFAULT_NAME,
+                     "RAWIMU: IMU: '" << name << "', rate= " << rate
+                                      << "; gyro scale= "  << gyro_scale_  << " rad/s/LSB"
+                                      << "; accel scale= " << accel_scale_ << " m/s^2/LSB");
+    }
+
+    void publishImu(const RAWIMUSXMem* raw)
+    {
+      boost::shared_ptr<sensor_msgs::Imu> imu = AllocROSMessage<sensor_msgs::Imu>();
+
+      imu->orientation_covariance[0] = -1.0; // Orientation not provided
+
+      imu->angular_velocity.x    =  gyro_scale_  * raw->x_gyro;
+      imu->angular_velocity.y    = -gyro_scale_  * raw->neg_y_gyro;
+      imu->angular_velocity.z    =  gyro_scale_  * raw->z_gyro;
+
+      imu->linear_acceleration.x =  accel_scale_ * raw->x_accel;
+      imu->linear_acceleration.y = -accel_scale_ * raw->neg_y_accel;
+      imu->linear_acceleration.z =  accel_scale_ * raw->z_accel;
+
+      Imu_pub_.publish(imu);
+    }
+
+    void addToBatch(const RAWIMUSXMem* raw)
+    {
+      if(!batch_)
+      {
+        batch_ = AllocROSMessage<novatel_oem7_msgs::IMUBatch>();
+        batch_->num_samples = 0;
+
+        // Recycled messages keep their capacity.
+        batch_->stamp.reserve(                batch_size_);
+        batch_->gnss_week.reserve(            batch_size_);
+        batch_->gnss_seconds.reserve(         batch_size_);
+        batch_->imu_status.reserve(           batch_size_);
+        batch_->angular_velocity_x.reserve(   batch_size_);
+        batch_->angular_velocity_y.reserve(   batch_size_);
+        batch_->angular_velocity_z.reserve(   batch_size_);
+        batch_->linear_acceleration_x.reserve(batch_size_);
+        batch_->linear_acceleration_y.reserve(batch_size_);
+        batch_->linear_acceleration_z.reserve(batch_size_);
+      }
+
+      batch_->imu_type = raw->imu_type;
+
+      batch_->stamp.push_back(                 Oem7MessageContext::current().getStamp());
+      batch_->gnss_week.push_back(             raw->gnss_week);
+      batch_->gnss_seconds.push_back(          raw->gnss_week_seconds);
+      batch_->imu_status.push_back(            raw->imu_status);
+      batch_->angular_velocity_x.push_back(    gyro_scale_  * raw->x_gyro);
+      batch_->angular_velocity_y.push_back(   -gyro_scale_  * raw->neg_y_gyro);
+      batch_->angular_velocity_z.push_back(    gyro_scale_  * raw->z_gyro);
+      batch_->linear_acceleration_x.push_back( accel_scale_ * raw->x_accel);
+      batch_->linear_acceleration_y.push_back(-accel_scale_ * raw->neg_y_accel);
+      batch_->linear_acceleration_z.push_back( accel_scale_ * raw->z_accel);
+
+      if(++batch_->num_samples >= batch_size_)
+      {
+        IMUBatch_pub_.publish(batch_); // Stamped as the last sample.
+        batch_.reset();
+      }
+    }
+
+  public:
+    RAWIMUHandler():
+      imu_type_(-1),
+      has_scale_(false),
+      gyro_scale_(0.0),
+      accel_scale_(0.0),
+      batch_size_(10)
+    {
+    }
+
+    ~RAWIMUHandler()
+    {
+    }
+
+    void initialize(ros::NodeHandle& nh)
+    {
+      nh_ = nh;
+
+      Imu_pub_.setup<sensor_msgs::Imu>(               "RAWIMU",   nh);
+      IMUBatch_pub_.setup<novatel_oem7_msgs::IMUBatch>("IMUBatch", nh);
+
+      int batch_size = batch_size_;
+      getOem7Param(nh, "imu_batch_size", batch_size);
+      batch_size_ = std::max(batch_size, 1);
+
+      if(IMUBatch_pub_.isEnabled())
+      {
+        ROS_INFO_STREAM("RAWIMU: samples per IMUBatch: " << batch_size_);
+      }
+    }
+
+    const std::vector<int>& getMessageIds()
+    {
+      static const std::vector<int> MSG_IDS({RAWIMUSX_OEM7_MSGID});
+      return MSG_IDS;
+    }
+
+    void handleMsg(Oem7RawMessageIf::ConstPtr msg)
+    {
+      if(!Imu_pub_.isEnabled() && !IMUBatch_pub_.isEnabled())
+      {
+        return;
+      }
+
+      if(msg->getMessageFormat() != Oem7RawMessageIf::OEM7MSGFMT_BINARY ||
+         msg->getMessageDataLength() < OEM7_BINARY_MSG_SHORT_HDR_LEN + sizeof(RAWIMUSXMem))
+      {
+        ROS_WARN_THROTTLE(10, "RAWIMU: RAWIMUSX expected in short binary format; not decoded.");
+        return;
+      }
+
+      const RAWIMUSXMem* raw = reinterpret_cast<const RAWIMUSXMem*>(msg->getMessageData(OEM7_BINARY_MSG_SHORT_HDR_LEN));
+
+      updateScale(raw->imu_type);
+      if(!has_scale_)
+      {
+        return;
+      }
+
+      if(Imu_pub_.isEnabled())
+      {
+        publishImu(raw);
+      }
+
+      if(IMUBatch_pub_.isEnabled())
+      {
+        addToBatch(raw);
+      }
+    }
+  };
+}
+
+#include <pluginlib/class_list_macros.h>
+PLUGINLIB_EXPORT_CLASS(novatel_oem7_driver::RAWIMUHandler, novatel_oem7_driver::Oem7MessageHandlerIf)
@@ -110,7 +110,8 @@ namespace novatel_oem7_driver
       "Digital filtering enabled",
       "Aux3 event",
       "Aux2 event",
-      "Aux1 event"
+      "Aux1 event",
+      ""
   };
 
   /** Auxiliary 1 Status strings - refer to Oem7 manual. */
@@ -261,27 +262,67 @@ namespace novatel_oem7_driver
   };
 
 
-  void
-  get_status_info(
-      uint32_t bitmask,
-      const str_vector_t&       str_map,
-      str_vector_t&             str_list,
-      std::vector<uint8_t>&     bit_list)
+  /**
+   * Decodes a status word into the numbers of its set bits, and their descriptions.
+   *
+   * Receivers report the same status for long periods, so the result for the latest word is kept and reused
+   * until the word changes. Decoding visits set bits only.
+   */
+  class StatusWordDecoder
   {
-    for(int bit = 0;
-            bit < (sizeof(bitmask) * 8);
-            bit++)
+    static const size_t NUM_BITS = sizeof(uint32_t) * 8;
+
+    const str_vector_t& str_map_; ///< Description of each bit; empty if none.
+
+    bool                 valid_; ///< A word has been decoded.
+    uint32_t             word_;  ///< Last decoded word
+    std::vector<uint8_t> bits_;  ///< Set bits of word_
+    str_vector_t         strs_;  ///< Descriptions of set bits of word_
+
+  public:
+    explicit StatusWordDecoder(const str_vector_t& str_map):
+      str_map_(str_map),
+      valid_(false),
+      word_(0)
+    {
+      assert(str_map_.size() == NUM_BITS);
+
+      bits_.reserve(NUM_BITS);
+      strs_.reserve(NUM_BITS);
+    }
+
+    void decode(
+        uint32_t              word,
+        str_vector_t&         str_list,
+        std::vector<uint8_t>& bit_list)
     {
-      if(bitmask & (1 << bit))
+      if(!valid_ || word != word_)
       {
-        bit_list.push_back(bit);
-        if(str_map[bit].length() > 0)
+        bits_.clear();
+        strs_.clear();
+
+        for(uint32_t remaining = word;
+                     remaining != 0;
+                     remaining &= remaining - 1) // Clear the lowest set bit
         {
-          str_list.push_back(str_map[bit]);
+          const int bit = __builtin_ctz(remaining);
+
+          bits_.push_back(bit);
+          if(!str_map_[bit].empty())
+          {
+            strs_.push_back(str_map_[bit]);
+          }
         }
+
+        word_  = word;
+        valid_ = true;
       }
+
+      // Assignment reuses the capacity retained by recycled messages.
+      bit_list = bits_;
+      str_list = strs_;
     }
-  }
+  };
 
 
   /*** Handles RXSTATUS messages */
@@ -291,15 +332,22 @@ namespace novatel_oem7_driver
 
     std::string frame_id_;
 
+    StatusWordDecoder error_decoder_;
+    StatusWordDecoder rxstat_decoder_;
+    StatusWordDecoder aux1_stat_decoder_;
+    StatusWordDecoder aux2_stat_decoder_;
+    StatusWordDecoder aux3_stat_decoder_;
+    StatusWordDecoder aux4_stat_decoder_;
+
   public:
-    ReceiverStatusHandler()
+    ReceiverStatusHandler():
+      error_decoder_(    RECEIVER_ERROR_STRS),
+      rxstat_decoder_(   RECEIVER_STATUS_STRS),
+      aux1_stat_decoder_(AUX1_STATUS_STRS),
+      aux2_stat_decoder_(AUX2_STATUS_STRS),
+      aux3_stat_decoder_(AUX3_STATUS_STRS),
+      aux4_stat_decoder_(AUX4_STATUS_STRS)
     {
-      static const size_t NUM_BITS = sizeof(uint32_t) * 8;
-      assert(RECEIVER_ERROR_STRS.size() == NUM_BITS);
-      assert(AUX1_STATUS_STRS.size()    == NUM_BITS);
-      assert(AUX2_STATUS_STRS.size()    == NUM_BITS);
-      assert(AUX3_STATUS_STRS.size()    == NUM_BITS);
-      assert(AUX4_STATUS_STRS.size()    == NUM_BITS);
     }
 
     ~ReceiverStatusHandler()
@@ -323,12 +371,12 @@ namespace novatel_oem7_driver
       MakeROSMessage(msg, rxstatus);
 
       // Populate status strings:
-      get_status_info(rxstatus->error,     RECEIVER_ERROR_STRS,  rxstatus->error_strs,     rxstatus->error_bits);
-      get_status_info(rxstatus->rxstat,    RECEIVER_STATUS_STRS, rxstatus->rxstat_strs,    rxstatus->rxstat_bits);
-      get_status_info(rxstatus->aux1_stat, AUX1_STATUS_STRS,     rxstatus->aux1_stat_strs, rxstatus->aux1_stat_bits);
-      get_status_info(rxstatus->aux2_stat, AUX2_STATUS_STRS,     rxstatus->aux2_stat_strs, rxstatus->aux2_stat_bits);
-      get_status_info(rxstatus->aux3_stat, AUX3_STATUS_STRS,     rxstatus->aux3_stat_strs, rxstatus->aux3_stat_bits);
-      get_status_info(rxstatus->aux4_stat, AUX4_STATUS_STRS,     rxstatus->aux4_stat_strs, rxstatus->aux4_stat_bits);
+      error_decoder_.decode(    rxstatus->error,     rxstatus->error_strs,     rxstatus->error_bits);
+      rxstat_decoder_.decode(   rxstatus->rxstat,    rxstatus->rxstat_strs,    rxstatus->rxstat_bits);
+      aux1_stat_decoder_.decode(rxstatus->aux1_stat, rxstatus->aux1_stat_strs, rxstatus->aux1_stat_bits);
+      aux2_stat_decoder_.decode(rxstatus->aux2_stat, rxstatus->aux2_stat_strs, rxstatus->aux2_stat_bits);
+      aux3_stat_decoder_.decode(rxstatus->aux3_stat, rxstatus->aux3_stat_strs, rxstatus->aux3_stat_bits);
+      aux4_stat_decoder_.decode(rxstatus->aux4_stat, rxstatus->aux4_stat_strs, rxstatus->aux4_stat_bits);
 
       RXSTATUS_pub_.publish(rxstatus);
     }
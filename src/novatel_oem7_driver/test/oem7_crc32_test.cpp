@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// Oem7 CRC-32 implementations: against the reference, and on the binary messages in the test captures.
+//
+
+#include <oem7_crc32.hpp>
+#include <oem7_binary_framer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace novatel_oem7_driver;
+
+
+namespace
+{
+  const char* CAPTURES[] = {"align.gps", "bestpos.gps", "ins1.gps", "ins2.gps", "rxstatus.gps", "time.gps"};
+
+  std::vector<uint8_t> readCapture(const std::string& name)
+  {
+    std::ifstream file(std::string(OEM7_TEST_DATA_DIR) + "/" + name, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  /**
+   * Length of the binary message at data, from its header; 0 if not at a binary message.
+   */
+  size_t getBinaryMessageLength(const uint8_t* data, size_t len)
+  {
+    if(len < OEM7_BINARY_MSG_SHORT_HDR_LEN || data[0] != 0xAA || data[1] != 0x44)
+      return 0;
+
+    if(data[2] == 0x13)
+      return OEM7_BINARY_MSG_SHORT_HDR_LEN + data[3] + sizeof(uint32_t);
+
+    if(data[2] == 0x12 && len >= OEM7_BINARY_MSG_HDR_LEN)
+      return data[3] + reinterpret_cast<const Oem7MessageHeaderMem*>(data)->message_length + sizeof(uint32_t);
+
+    return 0;
+  }
+
+  /**
+   * Binary messages in the capture, {position, length}; skipping other input, e.g. ASCII responses.
+   */
+  std::vector<std::pair<size_t, size_t> > findBinaryMessages(const std::vector<uint8_t>& capture)
+  {
+    std::vector<std::pair<size_t, size_t> > msgs;
+    for(size_t pos = 0; pos < capture.size();)
+    {
+      const size_t len = getBinaryMessageLength(&capture[pos], capture.size() - pos);
+      if(len > 0 && pos + len <= capture.size())
+      {
+        msgs.push_back(std::make_pair(pos, len));
+        pos += len;
+      }
+      else
+      {
+        pos++;
+      }
+    }
+    return msgs;
+  }
+}
+
+
+TEST(Oem7CRC32Test, CheckValue)
+{
+  const std::string check = "123456789";
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(check.data());
+
+  EXPECT_EQ(0x2DFD2D88u, Oem7CRC32Bytewise(data, check.size()));
+  EXPECT_EQ(0x2DFD2D88u, Oem7CRC32Slice8(  data, check.size()));
+  EXPECT_EQ(0x2DFD2D88u, Oem7CRC32PCLMUL(  data, check.size()));
+  EXPECT_EQ(0x2DFD2D88u, Oem7CRC32(        data, check.size()));
+}
+
+TEST(Oem7CRC32Test, MatchesReference)
+{
+  std::mt19937 rng(42);
+  std::vector<uint8_t> data(4096 + 16);
+  for(auto& b: data)
+  {
+    b = rng();
+  }
+
+  // All alignments; all lengths through the PCLMUL folding thresholds; continued CRCs.
+  for(size_t offset = 0; offset < 16; offset++)
+  {
+    for(size_t len = 0; len <= 1024; len++)
+    {
+      const uint32_t seed = rng();
+      const uint32_t ref  = Oem7CRC32Bytewise(&data[offset], len, seed);
+
+      ASSERT_EQ(ref, Oem7CRC32Slice8(&data[offset], len, seed)) << "offset= " << offset << " len= " << len;
+      ASSERT_EQ(ref, Oem7CRC32PCLMUL(&data[offset], len, seed)) << "offset= " << offset << " len= " << len;
+      ASSERT_EQ(ref, Oem7CRC32(      &data[offset], len, seed)) << "offset= " << offset << " len= " << len;
+    }
+  }
+
+  const uint32_t ref = Oem7CRC32Bytewise(data.data(), 4096);
+  EXPECT_EQ(ref, Oem7CRC32PCLMUL(data.data(), 4096));
+  EXPECT_EQ(ref, Oem7CRC32(data.data() + 1000, 3096, Oem7CRC32(data.data(), 1000)));
+}
+
+TEST(Oem7CRC32Test, CaptureMessages)
+{
+  std::cout << "Oem7CRC32: " << getOem7CRC32Name() << std::endl;
+
+  for(const char* name: CAPTURES)
+  {
+    const std::vector<uint8_t> capture = readCapture(name);
+    ASSERT_FALSE(capture.empty()) << name;
+
+    const std::vector<std::pair<size_t, size_t> > msgs = findBinaryMessages(capture);
+    for(const auto& pos_len: msgs)
+    {
+      const size_t   pos = pos_len.first;
+      const size_t   len = pos_len.second;
+      const uint8_t* msg = &capture[pos];
+      ASSERT_EQ(0u, Oem7CRC32Bytewise(msg, len)) << name << " at " << pos;
+      ASSERT_EQ(0u, Oem7CRC32Slice8(  msg, len)) << name << " at " << pos;
+      ASSERT_EQ(0u, Oem7CRC32PCLMUL(  msg, len)) << name << " at " << pos;
+      ASSERT_EQ(0u, Oem7CRC32(        msg, len)) << name << " at " << pos;
+
+      // Any corruption is detected.
+      std::vector<uint8_t> corrupted(msg, msg + len);
+      corrupted[len / 2] ^= 0x10;
+      ASSERT_NE(0u, Oem7CRC32(corrupted.data(), len)) << name << " at " << pos;
+    }
+    EXPECT_GT(msgs.size(), 0u) << name;
+  }
+}
+
+TEST(Oem7CRC32Test, CaptureFraming)
+{
+  for(const char* name: CAPTURES)
+  {
+    const std::vector<uint8_t> capture = readCapture(name);
+    const std::vector<std::pair<size_t, size_t> > msgs = findBinaryMessages(capture);
+
+    // Read in pieces shorter than messages, so that messages span reads.
+    Oem7BinaryFramer framer;
+    size_t read_pos = 0;
+    size_t num_frames  = 0;
+    size_t framed_len  = 0;
+    size_t passed_len  = 0;
+    for(;;)
+    {
+      novatel_oem7::Oem7RawMessageIf::ConstPtr frame;
+      const uint8_t* pass;
+      size_t         pass_len;
+      Oem7BinaryFramer::Result result = framer.next(frame, pass, pass_len);
+
+      if(result == Oem7BinaryFramer::FRAME)
+      {
+        ASSERT_LT(num_frames, msgs.size()) << name;
+        EXPECT_EQ(msgs[num_frames].second, frame->getMessageDataLength()) << name;
+        EXPECT_EQ(0, memcmp(&capture[msgs[num_frames].first], frame->getMessageData(0), msgs[num_frames].second));
+
+        num_frames++;
+        framed_len += frame->getMessageDataLength();
+        continue;
+      }
+      if(result == Oem7BinaryFramer::PASSTHROUGH)
+      {
+        passed_len += pass_len;
+        continue;
+      }
+
+      if(read_pos == capture.size())
+        break;
+
+      boost::asio::mutable_buffer buf = framer.prepare();
+      const size_t len = std::min<size_t>(std::min<size_t>(boost::asio::buffer_size(buf), 37), capture.size() - read_pos);
+      memcpy(boost::asio::buffer_cast<uint8_t*>(buf), &capture[read_pos], len);
+      framer.commit(len);
+      read_pos += len;
+    }
+
+    EXPECT_EQ(msgs.size(), num_frames)                  << name;
+    EXPECT_EQ(capture.size(), framed_len + passed_len)  << name;
+    EXPECT_EQ(0u, framer.getNumCRCErrors())             << name;
+  }
+}
+
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2020 NovAtel Inc.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// Oem7TimeOffsetEstimator: on synthetic arrivals with known clock offset, drift and transport delay.
+//
+
+#include <oem7_time_offset_estimator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+using namespace novatel_oem7_driver;
+
+
+namespace
+{
+  const double MIN_DELAY = 0.002; ///< Smallest transport delay, s; included in the estimate.
+
+  /**
+   * Host clock with offset and drift relative to the receiver clock; arrivals delayed by exponential jitter.
+   */
+  class SyntheticClock
+  {
+    std::mt19937                           rng_;
+    std::exponential_distribution<double>  jitter_;
+
+  public:
+    double offset; ///< host - receiver time at receiver time 0, s
+    double drift;  ///< s/s
+
+    SyntheticClock(double o, double d, double mean_jitter):
+      rng_(7),
+      jitter_(1.0 / mean_jitter),
+      offset(o),
+      drift(d)
+    {
+    }
+
+    /**
+     * @return host time of a message sent at rcvr_t, without transport delay.
+     */
+    double toHostTime(double rcvr_t) const
+    {
+      return rcvr_t + offset + drift * rcvr_t;
+    }
+
+    /**
+     * @return host arrival time of a message sent at rcvr_t.
+     */
+    double arrive(double rcvr_t)
+    {
+      return toHostTime(rcvr_t) + MIN_DELAY + jitter_(rng_);
+    }
+  };
+}
+
+
+TEST(Oem7TimeOffsetEstimatorTest, NoEstimateWithoutSamples)
+{
+  Oem7TimeOffsetEstimator estimator;
+  EXPECT_FALSE(estimator.isValid());
+
+  estimator.addSample(1000.0, 1005.0);
+  EXPECT_TRUE(estimator.isValid());
+  EXPECT_DOUBLE_EQ(1005.0, estimator.toHostTime(1000.0));
+
+  estimator.reset();
+  EXPECT_FALSE(estimator.isValid());
+}
+
+TEST(Oem7TimeOffsetEstimatorTest, ConvergesWithDriftAndJitter)
+{
+  SyntheticClock clock(-3.5, 50e-6, 0.010); // 50 ppm; 10 ms mean jitter.
+  Oem7TimeOffsetEstimator estimator(60.0, 10);
+
+  const double t0 = 500000.0; // GPS seconds of week: large absolute times.
+  for(double t = t0; t < t0 + 180.0; t += 0.05)
+  {
+    estimator.addSample(t, clock.arrive(t));
+  }
+
+  const double t = t0 + 180.0;
+  EXPECT_NEAR(clock.drift, estimator.getDrift(), 5e-6);
+  EXPECT_NEAR(clock.toHostTime(t) + MIN_DELAY, estimator.toHostTime(t), 0.001); // Jitter rejected.
+}
+
+TEST(Oem7TimeOffsetEstimatorTest, RejectsDelayedOutliers)
+{
+  SyntheticClock clock(2.0, -20e-6, 0.001);
+  Oem7TimeOffsetEstimator estimator(60.0, 10);
+
+  const double t0 = 100000.0;
+  int n = 0;
+  for(double t = t0; t < t0 + 120.0; t += 0.1, n++)
+  {
+    const double delay = n % 7 == 0 ? 0.5 : 0.0; // Host stalls: arrivals held up by half a second.
+    estimator.addSample(t, clock.arrive(t) + delay);
+  }
+
+  const double t = t0 + 120.0;
+  EXPECT_NEAR(clock.toHostTime(t) + MIN_DELAY, estimator.toHostTime(t), 0.001);
+}
+
+TEST(Oem7TimeOffsetEstimatorTest, RestartsOnReceiverTimeJump)
+{
+  SyntheticClock clock(1.0, 0.0, 0.001);
+  Oem7TimeOffsetEstimator estimator(60.0, 10);
+
+  for(double t = 1000.0; t < 1100.0; t += 0.1)
+  {
+    estimator.addSample(t, clock.arrive(t));
+  }
+
+  // Receiver time steps back, e.g. a new week, while host time continues.
+  clock.offset += 1100.0 - 200.0;
+  for(double t = 200.0; t < 202.0; t += 0.1)
+  {
+    estimator.addSample(t, clock.arrive(t));
+  }
+  EXPECT_NEAR(clock.toHostTime(202.0) + MIN_DELAY, estimator.toHostTime(202.0), 0.002);
+
+  // Receiver time jumps ahead past the window.
+  clock.offset -= 5000.0;
+  for(double t = 5202.0; t < 5204.0; t += 0.1)
+  {
+    estimator.addSample(t, clock.arrive(t));
+  }
+  EXPECT_NEAR(clock.toHostTime(5204.0) + MIN_DELAY, estimator.toHostTime(5204.0), 0.002);
+}
+
+TEST(Oem7TimeOffsetEstimatorTest, RestartsOnHostClockStep)
+{
+  SyntheticClock clock(10.0, 0.0, 0.001);
+  Oem7TimeOffsetEstimator estimator(60.0, 10, 1.0);
+
+  for(double t = 1000.0; t < 1100.0; t += 0.1)
+  {
+    estimator.addSample(t, clock.arrive(t));
+  }
+
+  // Host clock set back, e.g. by NTP: arrivals earlier than the estimate allows.
+  clock.offset -= 5.0;
+  for(double t = 1100.0; t < 1102.0; t += 0.1)
+  {
+    estimator.addSample(t, clock.arrive(t));
+  }
+  EXPECT_NEAR(clock.toHostTime(1102.0) + MIN_DELAY, estimator.toHostTime(1102.0), 0.002);
+}